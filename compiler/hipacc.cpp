@@ -73,7 +73,7 @@ void printUsage() {
     << "  -emit-renderscript      Emit Renderscript code for Android\n"
     << "  -emit-filterscript      Emit Filterscript code for Android\n"
     << "  -emit-vivado            Emit C++ code for Vivado HLS\n"
-    << "  -emit-padding <n>       Emit CUDA/OpenCL/Renderscript image padding, using alignment of <n> bytes for GPU devices\n"
+    << "  -emit-padding <n>       Emit CUDA/OpenCL/Renderscript/C++ image padding, using alignment of <n> bytes\n"
     << "  -target <n>             Generate code for GPUs with code name <n>.\n"
     << "                          Code names for CUDA/OpenCL on NVIDIA devices are:\n"
     << "                            'Fermi-20' and 'Fermi-21' for Fermi architecture.\n"
@@ -97,9 +97,17 @@ void printUsage() {
     << "                          Valid values for OpenCL: 'off' and 'Array2D'\n"
     << "  -use-local <o>          Enable/disable usage of shared/local memory in CUDA/OpenCL to stage image pixels to scratchpad\n"
     << "                          Valid values: 'on' and 'off'\n"
-    << "  -vectorize <o>          Enable/disable vectorization of generated CUDA/OpenCL code\n"
+    << "  -vectorize <o>          Enable/disable vectorization of generated CUDA/OpenCL/C++ code\n"
     << "                          Valid values: 'on' and 'off'\n"
     << "  -pixels-per-thread <n>  Specify how many pixels should be calculated per thread\n"
+    << "  -cpu-threads <n>        Specify how many threads should execute C++ kernels (OpenMP)\n"
+    << "                          Use 0 to select the number of threads at run-time\n"
+    << "  -cpu-vector-width <n>   Specify the width in bits of vector registers for vectorized C++ kernels, e.g. 256 for AVX2\n"
+    << "                          Use 0 to select the width of the target at C++ compile time (default)\n"
+    << "  -cpu-zero-copy <o>      Enable/disable wrapping of host memory by images in C++ code\n"
+    << "                          Valid values: 'on' and 'off'\n"
+    << "  -fuse-kernels <o>       Enable/disable computing intermediate images within their consumer kernel in C++ code\n"
+    << "                          Valid values: 'on' and 'off'\n"
     << "  -target-II <n>          Specify target Initiation Interval for Vivado\n"
     << "  -rs-package <string>    Specify Renderscript package name. (default: \"org.hipacc.rs\")\n"
     << "  -o <file>               Write output to <file>\n"
@@ -319,6 +327,62 @@ int main(int argc, char *argv[]) {
       ++i;
       continue;
     }
+    if (StringRef(argv[i]) == "-cpu-threads") {
+      assert(i<(argc-1) && "Mandatory integer parameter for -cpu-threads switch missing.");
+      std::istringstream buffer(argv[i+1]);
+      int val;
+      buffer >> val;
+      if (buffer.fail() || val < 0) {
+        llvm::errs() << "ERROR: Expected non-negative integer parameter for -cpu-threads switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      compilerOptions.setCPUThreads(val);
+      ++i;
+      continue;
+    }
+    if (StringRef(argv[i]) == "-cpu-vector-width") {
+      assert(i<(argc-1) && "Mandatory integer parameter for -cpu-vector-width switch missing.");
+      std::istringstream buffer(argv[i+1]);
+      int val;
+      buffer >> val;
+      if (buffer.fail() || val < 0 || val % 64) {
+        llvm::errs() << "ERROR: Expected non-negative multiple of 64 as parameter for -cpu-vector-width switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      compilerOptions.setCPUVectorBits(val);
+      ++i;
+      continue;
+    }
+    if (StringRef(argv[i]) == "-cpu-zero-copy") {
+      assert(i<(argc-1) && "Mandatory zero-copy specification for -cpu-zero-copy switch missing.");
+      if (StringRef(argv[i+1]) == "off") {
+        compilerOptions.setCPUZeroCopy(USER_OFF);
+      } else if (StringRef(argv[i+1]) == "on") {
+        compilerOptions.setCPUZeroCopy(USER_ON);
+      } else {
+        llvm::errs() << "ERROR: Expected valid zero-copy specification for -cpu-zero-copy switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      ++i;
+      continue;
+    }
+    if (StringRef(argv[i]) == "-fuse-kernels") {
+      assert(i<(argc-1) && "Mandatory fusion specification for -fuse-kernels switch missing.");
+      if (StringRef(argv[i+1]) == "off") {
+        compilerOptions.setFuseKernels(USER_OFF);
+      } else if (StringRef(argv[i+1]) == "on") {
+        compilerOptions.setFuseKernels(USER_ON);
+      } else {
+        llvm::errs() << "ERROR: Expected valid fusion specification for -fuse-kernels switch.\n\n";
+        printUsage();
+        return EXIT_FAILURE;
+      }
+      ++i;
+      continue;
+    }
     if (StringRef(argv[i]) == "-target-II") {
       assert(i<(argc-1) && "Mandatory target Initiation Interval amount missing.");
       std::istringstream buffer(argv[i+1]);
@@ -445,6 +509,34 @@ int main(int argc, char *argv[]) {
     // kernels are timed internally by the runtime in case of exploration
     compilerOptions.setTimeKernels(OFF);
   }
+  // Multithreading is only supported for C/C++ code generation
+  if (!compilerOptions.emitC99() &&
+      compilerOptions.useCPUThreads(USER_ON)) {
+    llvm::errs() << "Warning: -cpu-threads is only supported for C/C++ code generation!\n"
+                 << "  Option ignored!\n";
+    compilerOptions.setCPUThreads(1);
+  }
+  // The vector width is only used for C/C++ code generation
+  if (!compilerOptions.emitC99() &&
+      compilerOptions.getCPUVectorBits()) {
+    llvm::errs() << "Warning: -cpu-vector-width is only supported for C/C++ code generation!\n"
+                 << "  Option ignored!\n";
+    compilerOptions.setCPUVectorBits(0);
+  }
+  // Zero-copy images are only supported for C/C++ code generation
+  if (!compilerOptions.emitC99() &&
+      compilerOptions.useCPUZeroCopy(USER_ON)) {
+    llvm::errs() << "Warning: -cpu-zero-copy is only supported for C/C++ code generation!\n"
+                 << "  Option ignored!\n";
+    compilerOptions.setCPUZeroCopy(USER_OFF);
+  }
+  // Kernel fusion is only supported for C/C++ code generation
+  if (!compilerOptions.emitC99() &&
+      compilerOptions.fuseKernels(USER_ON)) {
+    llvm::errs() << "Warning: -fuse-kernels is only supported for C/C++ code generation!\n"
+                 << "  Option ignored!\n";
+    compilerOptions.setFuseKernels(USER_OFF);
+  }
   // Invalid OpenCL FPGA specification for kernel configuration
   if (compilerOptions.emitOpenCLFPGA()){
     if ( compilerOptions.getKernelConfigX() != 1 || 
@@ -45,6 +45,8 @@ float hipacc_last_timing = 0.0f;
 #include "kernel.hpp"
 #include "mask.hpp"
 #include "pyramid.hpp"
+#include "recursive.hpp"
+#include "scan.hpp"
 
 namespace hipacc {
 float hipacc_last_kernel_timing() {
@@ -50,6 +50,7 @@ enum class Boundary : uint8_t {
 enum class Interpolate : uint8_t {
     NO = 0,
     NN,
+    RS,
     LF,
     CF,
     L3
@@ -238,15 +239,18 @@ class BoundaryCondition {
 };
 
 
-template<typename data_t>
+// pixels are read through the boundary handling of the derived Accessor,
+// which is known statically
+template<typename data_t, typename accessor_t>
 class Interpolation {
     protected:
         const Interpolate imode;
-        // dummy reference to return a reference for interpolation
-        data_t interpol_init;
-        data_t &interpol_val;
+        // per-thread value to return a reference for interpolation
+        PerThread<data_t> interpol_val;
 
-        virtual data_t &pixel_bh(int x, int y) = 0;
+        data_t &pixel_bh(int x, int y) {
+            return static_cast<accessor_t *>(this)->pixel_bh(x, y);
+        }
 
         float bicubic_spline(float diff) const {
             // Cubic Convolution Interpolation for Digital Image Processing
@@ -295,7 +299,7 @@ class Interpolation {
 
     public:
         explicit Interpolation(const Interpolate imode) :
-            imode(imode), interpol_init(), interpol_val(interpol_init) {}
+            imode(imode), interpol_val() {}
         Interpolation() : Interpolation(Interpolate::NO) {}
 
         data_t &interpolate(ElementIterator *EI, const int offset_x, const int offset_y, const int width, const int height,
@@ -320,6 +324,9 @@ class Interpolation {
                 case Interpolate::NN:
                     interpol_val = pixel_bh(x_mapped, y_mapped);
                     break;
+                case Interpolate::RS:
+                    return pixel_bh((int)(offset_x + stride_x*(x - EI->offset_x())) + xf,
+                                    (int)(offset_y + stride_y*(y - EI->offset_y())) + yf);
                 case Interpolate::LF:
                     interpol_val = convert<data_t>(
                         (1.0f - x_frac) * (1.0f - y_frac) * as_float(pixel_bh(x_int    , y_int)) +
@@ -410,7 +417,7 @@ class AccessorBase {
     protected:
         const int width_, height_;
         const int offset_x_, offset_y_;
-        ElementIterator *EI;
+        PerThread<ElementIterator *> EI;
 
         void set_iterator(ElementIterator *ei) { EI = ei; }
 
@@ -428,7 +435,7 @@ class AccessorBase {
 
 
 template<typename data_t>
-class Accessor : public AccessorBase, BoundaryCondition<data_t>, Interpolation<data_t> {
+class Accessor : public AccessorBase, BoundaryCondition<data_t>, Interpolation<data_t, Accessor<data_t>> {
     private:
         using BoundaryCondition<data_t>::img;
         using BoundaryCondition<data_t>::bmode;
@@ -437,14 +444,14 @@ class Accessor : public AccessorBase, BoundaryCondition<data_t>, Interpolation<d
         using BoundaryCondition<data_t>::clamp;
         using BoundaryCondition<data_t>::repeat;
         using BoundaryCondition<data_t>::mirror;
-        using Interpolation<data_t>::interpolate;
-        using Interpolation<data_t>::imode;
+        using Interpolation<data_t, Accessor<data_t>>::interpolate;
+        using Interpolation<data_t, Accessor<data_t>>::imode;
 
         data_t &interpolate(const int x, const int y, const int xf=0, const int yf=0) {
             return interpolate(EI, offset_x_, offset_y_, width_, height_, x, y, xf, yf);
         }
 
-        virtual data_t &pixel_bh(int x, int y) override {
+        data_t &pixel_bh(int x, int y) {
             data_t *ret = &dummy;
             int lower_x = offset_x_;
             int lower_y = offset_y_;
@@ -473,7 +480,6 @@ class Accessor : public AccessorBase, BoundaryCondition<data_t>, Interpolation<d
                 case Boundary::CONSTANT:
                     if (x < lower_x || x >= upper_x ||
                         y < lower_y || y >= upper_y) {
-                        dummy = const_val;
                         ret = &dummy;
                     } else {
                         ret = &img.pixel(x, y);
@@ -489,25 +495,25 @@ class Accessor : public AccessorBase, BoundaryCondition<data_t>, Interpolation<d
         Accessor(Image<data_t> &Img, const Interpolate imode = Interpolate::NO) :
             AccessorBase(Img.width(), Img.height(), 0, 0),
             BoundaryCondition<data_t>(BoundaryCondition<data_t>(Img, 0, 0, Boundary::CLAMP)),
-            Interpolation<data_t>(imode)
+            Interpolation<data_t, Accessor<data_t>>(imode)
         {}
 
         Accessor(Image<data_t> &Img, const int width, const int height, const int xf, const int yf, const Interpolate imode = Interpolate::NO) :
             AccessorBase(width, height, xf, yf),
             BoundaryCondition<data_t>(BoundaryCondition<data_t>(Img, 0, 0, Boundary::CLAMP)),
-            Interpolation<data_t>(imode)
+            Interpolation<data_t, Accessor<data_t>>(imode)
         {}
 
         Accessor(const BoundaryCondition<data_t> &BC, const Interpolate imode = Interpolate::NO) :
             AccessorBase(BC.img.width(), BC.img.height(), 0, 0),
             BoundaryCondition<data_t>(BC),
-            Interpolation<data_t>(imode)
+            Interpolation<data_t, Accessor<data_t>>(imode)
         {}
 
         Accessor(const BoundaryCondition<data_t> &BC, const int width, const int height, const int xf, const int yf, const Interpolate imode = Interpolate::NO) :
             AccessorBase(width, height, xf, yf),
             BoundaryCondition<data_t>(BC),
-            Interpolation<data_t>(imode)
+            Interpolation<data_t, Accessor<data_t>>(imode)
         {}
 
         data_t &operator()() {
@@ -525,6 +531,18 @@ class Accessor : public AccessorBase, BoundaryCondition<data_t>, Interpolation<d
             return interpolate(EI->x(), EI->y(), M.x(), M.y());
         }
 
+        // statically bound offsets for Masks and Domains
+        template<typename data_m>
+        data_t &operator()(Mask<data_m> &M) {
+            assert(EI && "ElementIterator not set!");
+            return interpolate(EI->x(), EI->y(), M.x(), M.y());
+        }
+
+        data_t &operator()(Domain &D) {
+            assert(EI && "ElementIterator not set!");
+            return interpolate(EI->x(), EI->y(), D.x(), D.y());
+        }
+
 
         Accessor<data_t> &operator=(Image<data_t> &other) {
             assert(width_ == other.width() && height_ == other.height() &&
@@ -574,6 +592,7 @@ class Accessor : public AccessorBase, BoundaryCondition<data_t>, Interpolation<d
 
     template<typename> friend class Image;
     template<typename, typename> friend class Kernel;
+    friend class Interpolation<data_t, Accessor<data_t>>;
 };
 
 } // end namespace hipacc
@@ -28,12 +28,63 @@
 #ifndef __ITERATIONSPACE_HPP__
 #define __ITERATIONSPACE_HPP__
 
+#include <algorithm>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "image.hpp"
 
 namespace hipacc {
 // forward declaration
 template<typename data_t> class Image;
 
+// number of threads executing kernels, fixed at first use
+inline int hipacc_num_threads() {
+    #ifdef _OPENMP
+    static const int num_threads = omp_get_max_threads();
+    #else
+    static const int num_threads = 1;
+    #endif
+    return num_threads;
+}
+
+// index of the calling thread while executing a kernel, 0 otherwise
+inline int &hipacc_thread_id() {
+    static thread_local int thread_id = 0;
+    return thread_id;
+}
+
+// value that is kept separately for each thread executing a kernel, e.g. the
+// iterator an Accessor or Mask refers to; values of different threads reside
+// in different cache lines
+template<typename T>
+class PerThread {
+    private:
+        struct Value { T val; };
+        static constexpr size_t pad = (64 + sizeof(Value) - 1) / sizeof(Value);
+        std::vector<Value> values;
+
+        T &get() { return values[hipacc_thread_id() * pad].val; }
+        const T &get() const { return values[hipacc_thread_id() * pad].val; }
+
+    public:
+        explicit PerThread(const T &val=T()) :
+            values(hipacc_num_threads() * pad, Value{val})
+        {}
+
+        PerThread &operator=(const T &val) {
+            get() = val;
+            return *this;
+        }
+
+        operator T &() { return get(); }
+        operator const T &() const { return get(); }
+        T operator->() const { return get(); }
+};
+
 class Coordinate {
     public:
         int x, y;
@@ -60,6 +111,7 @@ class IterationSpaceBase {
             protected:
                 const int min_x, min_y;
                 const int max_x, max_y;
+                const int end_y;
                 const IterationSpaceBase *iteration_space;
                 Coordinate coord;
 
@@ -69,10 +121,22 @@ class IterationSpaceBase {
                     min_y(offset_y),
                     max_x(offset_x+width),
                     max_y(offset_y+height),
+                    end_y(offset_y+height),
                     iteration_space(iteration_space),
                     coord(offset_x, offset_y)
                 {}
 
+                // iterate only over rows [first_row, last_row) of the block
+                ElementIterator(const int width, const int height, const int offset_x, const int offset_y, const IterationSpaceBase *iteration_space, const int first_row, const int last_row) :
+                    min_x(offset_x),
+                    min_y(offset_y),
+                    max_x(offset_x+width),
+                    max_y(offset_y+height),
+                    end_y(offset_y+last_row),
+                    iteration_space(first_row < last_row && width > 0 ? iteration_space : nullptr),
+                    coord(offset_x, offset_y+first_row)
+                {}
+
                 // increment so we iterate over elements in a block
                 ElementIterator &operator++() {
                     if (iteration_space) {
@@ -80,7 +144,7 @@ class IterationSpaceBase {
                         if (coord.x >= max_x) {
                             coord.x = min_x;
                             coord.y++;
-                            if (coord.y >= max_y) {
+                            if (coord.y >= end_y) {
                                 iteration_space = nullptr;
                             }
                         }
@@ -101,6 +165,9 @@ class IterationSpaceBase {
         ElementIterator begin() const {
             return ElementIterator(width_, height_, offset_x_, offset_y_, this);
         }
+        ElementIterator begin(const int first_row, const int last_row) const {
+            return ElementIterator(width_, height_, offset_x_, offset_y_, this, first_row, last_row);
+        }
         ElementIterator end() const { return ElementIterator(); }
 
         int width()    const { return width_; }
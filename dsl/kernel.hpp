@@ -28,6 +28,8 @@
 #ifndef __KERNEL_HPP__
 #define __KERNEL_HPP__
 
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 
 #include "iterationspace.hpp"
@@ -46,6 +48,20 @@ enum class Reduce : uint8_t {
     MEDIAN
 };
 
+// select median of the given values, the upper median for an even number
+template <typename T>
+T select_median(std::vector<T> &values, std::true_type) {
+    auto mid = values.begin() + values.size()/2;
+    std::nth_element(values.begin(), mid, values.end());
+    return *mid;
+}
+template <typename T>
+T select_median(std::vector<T> &values, std::false_type) {
+    assert(0 && "Reduce::MEDIAN is only supported for scalar types!");
+    return values[values.size()/2];
+}
+
+
 template<typename data_t, typename bin_t = data_t>
 class Kernel {
     private:
@@ -58,7 +74,10 @@ class Kernel {
         unsigned int num_bins_;
         bool executed_ = false;
         bool reduced_ = false;
-        bool break_iteration;
+        PerThread<bool> break_iteration;
+
+        // rows of the iteration space executed together by one thread
+        static constexpr int band_rows = 8;
 
     public:
         explicit Kernel(IterationSpace<data_t> &iteration_space) :
@@ -79,29 +98,47 @@ class Kernel {
 
         void add_accessor(AccessorBase *acc) { inputs_.push_back(acc); }
 
+        // apply kernel to bands of rows; each thread registers its own
+        // iterator at the accessors, pixels are computed independently
         void execute() {
             if (!executed_) {
-                auto end  = iteration_space_.end();
-                auto iter = iteration_space_.begin();
-                // register input & output accessors
-                for (auto acc : inputs_)
-                    acc->set_iterator(&iter);
-                output_.set_iterator(&iter);
+                const int num_bands = (iteration_space_.height() + band_rows - 1) / band_rows;
 
-                // apply kernel for whole iteration space
                 auto start_time = hipacc_time_micro();
-                while (iter != end) {
-                    kernel();
-                    ++iter;
+                #ifdef _OPENMP
+                #pragma omp parallel num_threads(hipacc_num_threads())
+                #endif
+                {
+                    #ifdef _OPENMP
+                    hipacc_thread_id() = omp_get_thread_num();
+                    #pragma omp for schedule(dynamic)
+                    #endif
+                    for (int band=0; band<num_bands; ++band) {
+                        const int first_row = band * band_rows;
+                        const int last_row = std::min(first_row + band_rows, iteration_space_.height());
+                        auto end  = iteration_space_.end();
+                        auto iter = iteration_space_.begin(first_row, last_row);
+                        // register input & output accessors
+                        for (auto acc : inputs_)
+                            acc->set_iterator(&iter);
+                        output_.set_iterator(&iter);
+
+                        // apply kernel for the rows of the band
+                        while (iter != end) {
+                            kernel();
+                            ++iter;
+                        }
+
+                        // de-register input & output accessors
+                        for (auto acc : inputs_)
+                            acc->set_iterator(nullptr);
+                        output_.set_iterator(nullptr);
+                    }
+                    hipacc_thread_id() = 0;
                 }
                 auto end_time = hipacc_time_micro();
                 hipacc_last_timing = (float)(end_time - start_time)/1000.0f;
 
-                // de-register input & output accessors
-                for (auto acc : inputs_)
-                    acc->set_iterator(nullptr);
-                output_.set_iterator(nullptr);
-
                 executed_ = true;
             }
         }
@@ -190,12 +227,12 @@ class Kernel {
         }
 
         int x() const {
-            assert(output_.EI!=ElementIterator() && "ElementIterator not set!");
+            assert(output_.EI && "ElementIterator not set!");
             return output_.x();
         }
 
         int y() const {
-            assert(output_.EI!=ElementIterator() && "ElementIterator not set!");
+            assert(output_.EI && "ElementIterator not set!");
             return output_.y();
         }
 
@@ -227,6 +264,8 @@ auto Kernel<data_t, bin_t>::convolve(Mask<data_m> &mask, Reduce mode, const Func
 
     // initialize result - calculate first iteration
     auto result = fun();
+    std::vector<decltype(result)> values;
+    if (mode == Reduce::MEDIAN) values.push_back(result);
 
     // advance iterator and apply kernel to remaining iteration space
     while (++iter != end && !break_iteration) {
@@ -235,10 +274,14 @@ auto Kernel<data_t, bin_t>::convolve(Mask<data_m> &mask, Reduce mode, const Func
             case Reduce::MIN:    result  = hipacc::math::min(fun(), result);         break;
             case Reduce::MAX:    result  = hipacc::math::max(fun(), result);         break;
             case Reduce::PROD:   result *= fun();                                    break;
-            case Reduce::MEDIAN: assert(0 && "Reduce::MEDIAN not implemented yet!"); break;
+            case Reduce::MEDIAN: values.push_back(fun());                            break;
         }
     }
 
+    // select median of all values
+    if (mode == Reduce::MEDIAN)
+        result = select_median(values, std::is_arithmetic<decltype(result)>());
+
     // de-register mask
     mask.set_iterator(nullptr);
 
@@ -257,6 +300,8 @@ auto Kernel<data_t, bin_t>::reduce(Domain &domain, Reduce mode, const Function &
 
     // initialize result - calculate first iteration
     auto result = fun();
+    std::vector<decltype(result)> values;
+    if (mode == Reduce::MEDIAN) values.push_back(result);
 
     // advance iterator and apply kernel to remaining iteration space
     while (++iter != end && !break_iteration) {
@@ -265,10 +310,14 @@ auto Kernel<data_t, bin_t>::reduce(Domain &domain, Reduce mode, const Function &
             case Reduce::MIN:    result  = hipacc::math::min(fun(), result);         break;
             case Reduce::MAX:    result  = hipacc::math::max(fun(), result);         break;
             case Reduce::PROD:   result *= fun();                                    break;
-            case Reduce::MEDIAN: assert(0 && "Reduce::MEDIAN not implemented yet!"); break;
+            case Reduce::MEDIAN: values.push_back(fun());                            break;
         }
     }
 
+    // select median of all values
+    if (mode == Reduce::MEDIAN)
+        result = select_median(values, std::is_arithmetic<decltype(result)>());
+
     // de-register domain
     domain.set_iterator(nullptr);
 
@@ -143,7 +143,7 @@ class Domain : public MaskBase {
         };
 
     protected:
-        DomainIterator *DI;
+        PerThread<DomainIterator *> DI;
 
     public:
         Domain(const int size_x, const int size_y) :
@@ -171,11 +171,11 @@ class Domain : public MaskBase {
 
         ~Domain() {}
 
-        virtual int x() const override {
+        virtual int x() const override final {
             assert(DI && "DomainIterator for Domain not set!");
             return DI->x() - size_x_/2;
         }
-        virtual int y() const override {
+        virtual int y() const override final {
             assert(DI && "DomainIterator for Domain not set!");
             return DI->y() - size_y_/2;
         }
@@ -228,7 +228,7 @@ class Domain : public MaskBase {
 template<typename data_t>
 class Mask : public MaskBase {
     private:
-        ElementIterator *EI;
+        PerThread<ElementIterator *> EI;
         data_t *array;
 
         template <int size_y, int size_x>
@@ -272,11 +272,11 @@ class Mask : public MaskBase {
             }
         }
 
-        int x() const {
+        int x() const final {
             assert(EI && "ElementIterator for Mask not set!");
             return EI->x() - size_x_/2;
         }
-        int y() const {
+        int y() const final {
             assert(EI && "ElementIterator for Mask not set!");
             return EI->y() - size_y_/2;
         }
@@ -99,7 +99,10 @@ class Pyramid : public PyramidBase {
         std::vector<Image<data_t>> imgs_;
 
     public:
-        Pyramid(Image<data_t> &img, const int depth)
+        // levels of temporary pyramids may share memory with levels two or
+        // more stages apart; the reference implementation keeps all levels
+        Pyramid(Image<data_t> &img, const int depth,
+                const bool /*temporary*/=false)
             : PyramidBase(depth) {
             imgs_.push_back(img);
             int height = img.height()/2;
@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2013, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __RECURSIVE_HPP__
+#define __RECURSIVE_HPP__
+
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "image.hpp"
+#include "kernel.hpp"
+
+namespace hipacc {
+
+// impulse responses of recursive filters
+enum class Recursive : uint8_t {
+    GAUSSIAN = 0,   // Young/van Vliet, sigma is the standard deviation
+    EXPONENTIAL     // first-order smoothing, sigma is the decay length
+};
+
+template<typename data_t>
+data_t recursive_store(float val, std::true_type) {
+    return (data_t)std::floor(val + 0.5f);
+}
+template<typename data_t>
+data_t recursive_store(float val, std::false_type) {
+    return (data_t)val;
+}
+
+// Recursive (IIR) filter: causal and anti-causal passes along rows and
+// columns, the cost per pixel is independent of sigma
+template<typename data_t>
+void recursive_filter(const Image<data_t> &in, Image<data_t> &out,
+                      float sigma, Recursive mode=Recursive::GAUSSIAN) {
+    assert(in.width() == out.width() && in.height() == out.height() &&
+           "Size of input and output image have to be the same!");
+
+    // y[n] = b*x[n] + a1*y[n-1] + a2*y[n-2] + a3*y[n-3]
+    float b = 1.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+    if (sigma > 0.0f) {
+        if (mode == Recursive::GAUSSIAN) {
+            double s = std::max(sigma, 0.5f);
+            double q = s >= 2.5 ? 0.98711*s - 0.96330
+                                : 3.97156 - 4.14554*std::sqrt(1.0 - 0.26891*s);
+            double q2 = q*q, q3 = q2*q;
+            double b0 = 1.57825 + 2.44413*q + 1.4281*q2 + 0.422205*q3;
+            a1 = (float)((2.44413*q + 2.85619*q2 + 1.26661*q3) / b0);
+            a2 = (float)(-(1.4281*q2 + 1.26661*q3) / b0);
+            a3 = (float)(0.422205*q3 / b0);
+        } else {
+            a1 = (float)std::exp(-1.0 / sigma);
+        }
+        b = 1.0f - (a1 + a2 + a3);
+    }
+
+    const int width = in.width();
+    const int height = in.height();
+    std::vector<float> tmp(width*height);
+    std::vector<float> line(std::max(width, height));
+
+    // filter a line of n values with distance step, borders are clamped
+    auto filter = [&] (float *data, int n, int step) {
+        float y1 = data[0], y2 = y1, y3 = y1;
+        for (int i=0; i<n; ++i) {
+            float y0 = b*data[i*step] + a1*y1 + a2*y2 + a3*y3;
+            line[i] = y0;
+            y3 = y2; y2 = y1; y1 = y0;
+        }
+        y2 = y3 = y1;
+        for (int i=n-1; i>=0; --i) {
+            float y0 = b*line[i] + a1*y1 + a2*y2 + a3*y3;
+            data[i*step] = y0;
+            y3 = y2; y2 = y1; y1 = y0;
+        }
+    };
+
+    auto start = hipacc_time_micro();
+    const data_t *src = in.data();
+    for (int i=0; i<width*height; ++i) tmp[i] = (float)src[i];
+    for (int y=0; y<height; ++y) filter(&tmp[y*width], width, 1);
+    for (int x=0; x<width; ++x) filter(&tmp[x], height, width);
+    data_t *dst = out.data();
+    for (int i=0; i<width*height; ++i)
+        dst[i] = recursive_store<data_t>(tmp[i], std::is_integral<data_t>());
+    auto end = hipacc_time_micro();
+    hipacc_last_timing = (float)(end - start)/1000.0f;
+}
+
+} // end namespace hipacc
+
+#endif // __RECURSIVE_HPP__
+
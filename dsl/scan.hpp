@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2013, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __SCAN_HPP__
+#define __SCAN_HPP__
+
+#include "image.hpp"
+#include "kernel.hpp"
+
+namespace hipacc {
+
+// 2D inclusive scan (summed-area table for Reduce::SUM): each output pixel
+// holds the combination of all input pixels above and left of it, including
+// the pixel itself; acc_t has to be wide enough to hold the accumulated value
+template<typename acc_t, typename data_t>
+void integral_image(const Image<data_t> &in, Image<acc_t> &out,
+                    Reduce mode=Reduce::SUM) {
+    assert(in.width() == out.width() && in.height() == out.height() &&
+           "Size of input and output image have to be the same!");
+    assert((mode == Reduce::SUM || mode == Reduce::MIN ||
+            mode == Reduce::MAX) &&
+           "Only SUM, MIN, and MAX are supported for integral images!");
+
+    auto combine = [mode] (acc_t a, acc_t b) -> acc_t {
+        switch (mode) {
+            default:
+            case Reduce::SUM: return a + b;
+            case Reduce::MIN: return b < a ? b : a;
+            case Reduce::MAX: return a < b ? b : a;
+        }
+    };
+
+    const int width = in.width();
+    const int height = in.height();
+    const data_t *src = in.data();
+    acc_t *dst = out.data();
+
+    auto start = hipacc_time_micro();
+    for (int y=0; y<height; ++y) {
+        acc_t row = (acc_t)src[y*width];
+        for (int x=0; x<width; ++x) {
+            if (x) row = combine(row, (acc_t)src[y*width + x]);
+            dst[y*width + x] = y ? combine(dst[(y-1)*width + x], row) : row;
+        }
+    }
+    auto end = hipacc_time_micro();
+    hipacc_last_timing = (float)(end - start)/1000.0f;
+}
+
+} // end namespace hipacc
+
+#endif // __SCAN_HPP__
+
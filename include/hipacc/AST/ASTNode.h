@@ -82,6 +82,10 @@ ForStmt *createForStmt(ASTContext &Ctx, Stmt *Init, Expr *Cond, Expr *Inc, Stmt
 WhileStmt *createWhileStmt(ASTContext &Ctx, VarDecl *Var, Expr *Cond, Stmt
     *Body);
 
+// creates a statement AST node annotated with attributes, e.g. loop hints
+AttributedStmt *createAttributedStmt(ASTContext &Ctx, ArrayRef<const Attr *>
+    Attrs, Stmt *SubStmt);
+
 // creates an AST node for binary operators
 UnaryOperator *createUnaryOperator(ASTContext &Ctx, Expr *input,
     UnaryOperator::Opcode opc, QualType ResTy);
@@ -40,6 +40,7 @@
 #include <clang/AST/ExprCXX.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Sema/Ownership.h>
+#include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/ADT/SmallVector.h>
 
 #include "hipacc/Analysis/KernelStatistics.h"
@@ -51,6 +52,9 @@
 #include "hipacc/Vectorization/SIMDTypes.h"
 
 #include <functional>
+#include <map>
+#include <type_traits>
+#include <vector>
 
 //===----------------------------------------------------------------------===//
 // Statement/expression transformations
@@ -69,6 +73,17 @@ typedef union border_variant {
   border_variant() : borderVal(0) {}
 } border_variant;
 
+// interval of values of an integer expression; empty as long as no value has
+// been assigned to a variable
+class ValueInterval {
+  public:
+    enum Kind { Empty, Known, Unknown } kind;
+    int64_t lo, hi;
+
+    ValueInterval(Kind kind=Unknown, int64_t lo=0, int64_t hi=0) :
+      kind(kind), lo(lo), hi(hi) {}
+};
+
 class ASTTranslate : public StmtVisitor<ASTTranslate, Stmt *> {
   private:
     enum TranslationMode {
@@ -99,11 +114,73 @@ class ASTTranslate : public StmtVisitor<ASTTranslate, Stmt *> {
     DeclRefExpr *convTmp;
     Reduce convMode;
     int convIdxX, convIdxY;
+    // loop variables and constant tables of Masks/Domains lowered to loops
+    Expr *convIdxXRef, *convIdxYRef;
+    std::map<HipaccMask *, DeclRefExpr *> maskTables;
+    CompoundStmt *maskTableCStmt;
+    // row pass function, or column function of running column sums, and its
+    // arguments for separable convolutions
+    std::map<CXXMemberCallExpr *, std::pair<FunctionDecl *,
+      SmallVector<VarDecl *, 16>>> convRowFuns;
+    // values of median convolutions/reductions: stored per iteration into an
+    // array or counted in a histogram, selected after the last iteration;
+    // sliding histograms are kept across the pixels of a row; FPGA targets
+    // keep the values in scalar registers instead of an array
+    class MedianValues {
+      public:
+        DeclRefExpr *values;
+        SmallVector<DeclRefExpr *, 16> registers;
+        unsigned index;
+        bool histogram, sliding;
+
+        MedianValues() : values(nullptr), index(0), histogram(false),
+          sliding(false) {}
+        MedianValues(DeclRefExpr *values, bool histogram, bool sliding) :
+          values(values), index(0), histogram(histogram), sliding(sliding) {}
+    };
+    std::map<DeclRefExpr *, MedianValues> medianValues;
+    // math functions depending only on pixel values of 8/16-bit images (e.g.
+    // range weights of bilateral filters) are looked up in tables computed at
+    // the beginning of the kernel
+    class RangeValue {
+      public:
+        enum Kind { Invariant, Index, Dependent, Unknown } kind;
+        // VarDecl or Expr of the index the value depends on
+        const void *key;
+        Expr *index;
+        int64_t lo, hi;
+        bool call;
+
+        RangeValue(Kind kind=Unknown) :
+          kind(kind), key(nullptr), index(nullptr), lo(0), hi(0),
+          call(false) {}
+    };
+    class RangeTable {
+      public:
+        Expr *expr, *index;
+        const void *key;
+        int64_t lo, hi;
+        DeclRefExpr *table;
+    };
+    SmallVector<RangeTable, 4> rangeTables;
+    llvm::DenseMap<Expr *, unsigned> rangeTableMap;
+    llvm::DenseMap<const void *, Expr *> rangeSubst;
+    llvm::SmallPtrSet<VarDecl *, 16> rangeModified;
+    // value ranges of integer variables and sums of convolutions, used to
+    // narrow bit widths
+    llvm::DenseMap<const VarDecl *, ValueInterval> varIntervals;
+    llvm::DenseMap<const Expr *, ValueInterval> convIntervals;
+    llvm::SmallPtrSet<const VarDecl *, 16> escapingVars;
+    std::map<HipaccMask *, std::vector<double>> intervalCoeffs;
+    HipaccMask *intervalMask;
+    int intervalMaskX, intervalMaskY;
+    bool intervalChanged, intervalWiden;
 
     SmallVector<HipaccMask *, 4> redDomains;
     SmallVector<DeclRefExpr *, 4> redTmps;
     SmallVector<Reduce, 4> redModes;
     SmallVector<int, 4> redIdxX, redIdxY;
+    SmallVector<Expr *, 4> redIdxXRef, redIdxYRef;
     SmallVector<LabelDecl *, 4> breakLabels;
     SmallVector<bool, 4> containsBreak;
 
@@ -207,6 +284,12 @@ class ASTTranslate : public StmtVisitor<ASTTranslate, Stmt *> {
       if (S==nullptr)
         return nullptr;
 
+      // replace range-dependent expressions by table lookups
+      if ((std::is_same<T, Expr>::value || std::is_same<T, Stmt>::value) &&
+          !rangeTables.empty())
+        if (Stmt *R = cloneRange(S))
+          return static_cast<T *>(R);
+
       return static_cast<T *>(Visit(S));
     }
     template<class T> T *CloneDecl(T *D) {
@@ -314,8 +397,47 @@ class ASTTranslate : public StmtVisitor<ASTTranslate, Stmt *> {
         *stmt);
     Stmt *addBreakCheck(DeclRefExpr *break_var, Stmt *stmt);
     bool searchForBreakIterate(Stmt *S);
+    bool getMaskCoefficients(HipaccMask *Mask, std::vector<double> &coeffs);
+    Expr *createCoefficient(QualType QT, double coeff);
+    CXXOperatorCallExpr *getMaskProductAccess(LambdaExpr *LE, HipaccMask
+        *Mask);
+    bool getSeparableMask(HipaccMask *Mask, std::vector<double> &col,
+        std::vector<double> &row);
+    bool addSeparableConvolution(CXXMemberCallExpr *E, HipaccMask *Mask,
+        LambdaExpr *LE, CompoundStmt *outerCStmt);
+    bool addFactoredConvolution(HipaccMask *Mask, LambdaExpr *LE, CompoundStmt
+        *outerCStmt);
+    void addMedianValues(HipaccMask *Mask, FieldDecl *FD, LambdaExpr *LE,
+        DeclRefExpr *tmp_var, CompoundStmt *outerCStmt);
+    Stmt *addMedianSlidingWindow(HipaccMask *Mask, DeclRefExpr *tmp_var,
+        const std::function<Stmt *(int, int, Expr *, Expr *)>
+        &cloneIteration);
+    void addMedianSelection(DeclRefExpr *tmp_var, CompoundStmt *outerCStmt);
+    Expr *accessMedianValue(MedianValues &median, unsigned idx);
+    Expr *getMaskIdx(int idx, Expr *idx_ref, int offset=0);
+    Expr *accessMaskTable(HipaccMask *Mask, Expr *idx_x, Expr *idx_y);
+    bool addConvolutionLoop(HipaccMask *Mask, const std::function<Stmt *(int,
+          int, Expr *, Expr *)> &cloneIteration, CompoundStmt *outerCStmt);
     Expr *convertConvolution(CXXMemberCallExpr *E);
 
+    // RangeTable.cpp
+    bool isMathFunction(FunctionDecl *FD);
+    RangeValue classifyRange(Expr *E);
+    void findRangeTables(Stmt *S, int64_t max_size);
+    void addRangeTables(Stmt *S, SmallVector<Stmt *, 16> &kernelBody,
+        FunctionDecl *barrier=nullptr);
+    Stmt *cloneRange(Stmt *S);
+
+    // BitWidth.cpp
+    void inferValueIntervals(Stmt *S);
+    void updateValueIntervals(Stmt *S);
+    void joinVarInterval(VarDecl *VD, ValueInterval I);
+    ValueInterval getValueInterval(Expr *E);
+    ValueInterval getMaskInterval(CXXOperatorCallExpr *E, HipaccMask *Mask);
+    ValueInterval getConvolutionInterval(CXXMemberCallExpr *E);
+    int getIntervalBitwidthMask(ValueInterval I, QualType QT);
+    QualType getIntervalType(ValueInterval I, QualType QT);
+
     // Interpolation.cpp
     Expr *addNNInterpolationX(HipaccAccessor *Acc, Expr *idx_x);
     Expr *addNNInterpolationY(HipaccAccessor *Acc, Expr *idx_y);
@@ -388,9 +510,11 @@ class ASTTranslate : public StmtVisitor<ASTTranslate, Stmt *> {
     // OpenCLFPGA bit width reduction
     std::map<size_t, std::pair< std::string, int> > bwMap;
     std::map< std::string, int > bwMapTmp;
+    llvm::DenseMap<const ValueDecl *, int> bwInferred;
 
     Expr *maskBitwidth(Expr* E, int mask);
-    int getBitwidthMask(size_t lineNum, std::string varName);
+    int getBitwidthMask(size_t lineNum, std::string varName, const ValueDecl
+        *VD=nullptr);
 
   public:
     ASTTranslate(ASTContext& Ctx, FunctionDecl *kernelDecl, HipaccKernel
@@ -415,6 +539,14 @@ class ASTTranslate : public StmtVisitor<ASTTranslate, Stmt *> {
       convTmp(nullptr),
       convIdxX(0),
       convIdxY(0),
+      convIdxXRef(nullptr),
+      convIdxYRef(nullptr),
+      maskTableCStmt(nullptr),
+      intervalMask(nullptr),
+      intervalMaskX(0),
+      intervalMaskY(0),
+      intervalChanged(false),
+      intervalWiden(false),
       bh_start_left(nullptr),
       bh_start_right(nullptr),
       bh_start_top(nullptr),
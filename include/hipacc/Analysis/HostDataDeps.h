@@ -31,6 +31,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <set>
 #include <vector>
 #include <iostream>
 #include <sstream>
@@ -88,11 +89,13 @@ class DependencyTracker : public StmtVisitor<DependencyTracker> {
           this->Visit(const_cast<Stmt*>(S));
         }
       }
+      trackHostUses(analysisContext.getBody());
       if (DEBUG) std::cout << std::endl;
     }
 
     void VisitDeclStmt(DeclStmt *S);
     void VisitCXXMemberCallExpr(CXXMemberCallExpr *E);
+    void trackHostUses(Stmt *S);
 };
 
 
@@ -131,15 +134,24 @@ class HostDataDeps : public ManagedAnalysis {
     unsigned int outId, tmpId;
     std::vector<Node*> schedule;
 
+    // kernel fusion for C/C++ only, CUDA and OpenCL kernels are not fused:
+    // images accessed by host code, host accesses in source order, and spaces
+    // computed within their consumer
+    bool supported = true;
+    std::set<Image*> hostImages_;
+    std::vector<std::pair<SourceLocation, Image*>> hostUses_;
+    std::set<Space*> fusedSpaces_;
+
     // inner class definitions
     class IterationSpace {
       private:
         HipaccIterationSpace *iter;
         Image *image;
+        bool direct;
 
       public:
-        IterationSpace(HipaccIterationSpace *iter, Image *image)
-            : iter(iter), image(image) {
+        IterationSpace(HipaccIterationSpace *iter, Image *image, bool direct)
+            : iter(iter), image(image), direct(direct) {
         }
 
         std::string getName() {
@@ -149,6 +161,11 @@ class HostDataDeps : public ManagedAnalysis {
         Image *getImage() {
           return image;
         }
+
+        // covers the whole image, without offsets
+        bool isDirect() {
+          return direct;
+        }
     };
 
     class Accessor {
@@ -156,10 +173,16 @@ class HostDataDeps : public ManagedAnalysis {
         HipaccAccessor *acc;
         Image *image;
         Space *space;
+        bool direct;
 
       public:
-        Accessor(HipaccAccessor *acc, Image *image)
-            : acc(acc), image(image), space(nullptr) {
+        Accessor(HipaccAccessor *acc, Image *image, bool direct)
+            : acc(acc), image(image), space(nullptr), direct(direct) {
+        }
+
+        // reads the image without crop or interpolation
+        bool isDirect() {
+          return direct;
         }
 
         Space *getSpace() {
@@ -215,18 +238,23 @@ class HostDataDeps : public ManagedAnalysis {
     class Kernel {
       private:
         std::string name;
+        ValueDecl *decl;
         IterationSpace *iter;
         std::vector<Accessor*> accs;
 
       public:
-        Kernel(std::string name, IterationSpace *iter)
-            : name(name), iter(iter) {
+        Kernel(std::string name, ValueDecl *decl, IterationSpace *iter)
+            : name(name), decl(decl), iter(iter) {
         }
 
         std::string getName() {
           return name;
         }
 
+        ValueDecl *getDecl() {
+          return decl;
+        }
+
         IterationSpace *getIterationSpace() {
           return iter;
         }
@@ -330,13 +358,14 @@ class HostDataDeps : public ManagedAnalysis {
         Kernel *kernel;
         Space *outSpace;
         std::vector<Space*> inSpaces;
+        SourceLocation loc;
 
       public:
         std::vector<std::string> inStreams;
         std::string outStream;
 
-        Process(Kernel *kernel, Space *outSpace)
-            : Node(false), kernel(kernel), outSpace(outSpace) {
+        Process(Kernel *kernel, Space *outSpace, SourceLocation loc)
+            : Node(false), kernel(kernel), outSpace(outSpace), loc(loc) {
           outSpace->srcProcess = this;
         }
 
@@ -344,6 +373,11 @@ class HostDataDeps : public ManagedAnalysis {
           return kernel;
         }
 
+        // location of the kernel execution in host code
+        SourceLocation getLocation() {
+          return loc;
+        }
+
         Space *getOutSpace() {
           return outSpace;
         }
@@ -377,9 +411,18 @@ class HostDataDeps : public ManagedAnalysis {
     void addImage(ValueDecl *VD, HipaccImage *img);
     void addBoundaryCondition(ValueDecl *BCVD, HipaccBoundaryCondition *BC, ValueDecl *IVD);
     void addKernel(ValueDecl *KVD, ValueDecl *ISVD, std::vector<ValueDecl*> AVDS);
-    void addAccessor(ValueDecl *AVD, HipaccAccessor *acc, ValueDecl* IVD);
-    void addIterationSpace(ValueDecl *ISVD, HipaccIterationSpace *iter, ValueDecl *IVD);
-    void runKernel(ValueDecl *VD);
+    void addAccessor(ValueDecl *AVD, HipaccAccessor *acc, ValueDecl* IVD, bool direct);
+    void addIterationSpace(ValueDecl *ISVD, HipaccIterationSpace *iter, ValueDecl *IVD, bool direct);
+    void addHostUse(ValueDecl *IVD, SourceLocation loc);
+    void runKernel(ValueDecl *VD, SourceLocation loc);
+
+    // constructs not covered by the analysis, e.g. pyramids, disable fusion;
+    // the FPGA back ends require a complete dependency graph
+    void setUnsupported(const char *reason) {
+      assert(!compilerOptions.emitVivado() &&
+             !compilerOptions.emitOpenCLFPGA() && reason);
+      supported = false;
+    }
 
     void dump(Process *proc);
     void dump(Space *space);
@@ -391,6 +434,9 @@ class HostDataDeps : public ManagedAnalysis {
     void markProcess(Process *t);
     void markSpace(Space *s);
     void createSchedule();
+    Process *getProcess(Kernel *kernel);
+    bool isFusible(Space *s);
+    void markFusion();
     std::string declareFifo(std::string type, std::string name);
     std::string getEntrySignature(
         std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
@@ -422,6 +468,8 @@ class HostDataDeps : public ManagedAnalysis {
     std::string getInputStream(ValueDecl *VD);
     std::string getOutputStream(ValueDecl *VD);
     std::string getStreamDecl(ValueDecl *VD);
+    bool isFusedKernel(ValueDecl *KVD);
+    ValueDecl *getFusedKernel(ValueDecl *KVD, ValueDecl *AVD);
 
     static HostDataDeps *parse(ASTContext &Context,
         AnalysisDeclContext &analysisContext,
@@ -438,7 +486,12 @@ class HostDataDeps : public ManagedAnalysis {
         std::cout << std::endl;
       }
 
-      dataDeps.createSchedule();
+      if (compilerOptions.emitC99()) {
+        if (compilerOptions.fuseKernels())
+          dataDeps.markFusion();
+      } else {
+        dataDeps.createSchedule();
+      }
 
       return &dataDeps;
     }
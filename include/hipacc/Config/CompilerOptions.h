@@ -86,6 +86,9 @@ class CompilerOptions {
     CompilerOption local_memory;
     CompilerOption multiple_pixels;
     CompilerOption vectorize_kernels;
+    CompilerOption cpu_threads;
+    CompilerOption cpu_zero_copy;
+    CompilerOption fuse_kernels;
     // user defined values for target code features
     int kernel_config_x, kernel_config_y;
     int reduce_config_num_warps, reduce_config_num_hists;
@@ -94,6 +97,8 @@ class CompilerOptions {
     Texture texture_type;
     std::string rs_package_name, rs_directory;
     int target_ii;
+    int cpu_threads_num;
+    int cpu_vector_bits;
 
     void getOptionAsString(CompilerOption option, int val=-1) {
       switch (option) {
@@ -129,6 +134,9 @@ class CompilerOptions {
       local_memory(AUTO),
       multiple_pixels(AUTO),
       vectorize_kernels(OFF),
+      cpu_threads(OFF),
+      cpu_zero_copy(OFF),
+      fuse_kernels(OFF),
       kernel_config_x(128),
       kernel_config_y(1),
       reduce_config_num_warps(16),
@@ -138,7 +146,9 @@ class CompilerOptions {
       texture_type(Texture::None),
       rs_package_name("org.hipacc.rs"),
       rs_directory("/data/local/tmp"),
-      target_ii(1)
+      target_ii(1),
+      cpu_threads_num(0),
+      cpu_vector_bits(0)
     {}
 
     bool emitC99() { return target_lang == Language::C99; }
@@ -204,6 +214,18 @@ class CompilerOptions {
     std::string getRSPackageName() { return rs_package_name; }
     std::string getRSDirectory() { return rs_directory; }
     int getTargetII() { return target_ii; }
+    bool useCPUThreads(CompilerOption option=option_ou) {
+      return cpu_threads & option;
+    }
+    int getCPUThreads() { return cpu_threads_num; }
+    // 0 bits: width of the target, see HIPACC_CPU_VECTOR_BYTES in the runtime
+    int getCPUVectorBits() { return cpu_vector_bits; }
+    bool useCPUZeroCopy(CompilerOption option=option_ou) {
+      return cpu_zero_copy & option;
+    }
+    bool fuseKernels(CompilerOption option=option_ou) {
+      return fuse_kernels & option;
+    }
 
     void setTargetLang(Language lang) { target_lang = lang; }
     void setTargetDevice(Device td) { target_device = td; }
@@ -211,6 +233,8 @@ class CompilerOptions {
     void setTimeKernels(CompilerOption o) { time_kernels = o; }
     void setLocalMemory(CompilerOption o) { local_memory = o; }
     void setVectorizeKernels(CompilerOption o) { vectorize_kernels = o; }
+    void setCPUZeroCopy(CompilerOption o) { cpu_zero_copy = o; }
+    void setFuseKernels(CompilerOption o) { fuse_kernels = o; }
 
     void setTextureMemory(Texture type) {
       texture_type = type;
@@ -251,6 +275,17 @@ class CompilerOptions {
       target_ii = ii;
     }
 
+    void setCPUVectorBits(int bits) {
+      cpu_vector_bits = bits;
+    }
+
+    // 0 threads: use as many threads as the OpenMP runtime provides
+    void setCPUThreads(int threads) {
+      cpu_threads_num = threads;
+      if (threads != 1) cpu_threads = USER_ON;
+      else cpu_threads = USER_OFF;
+    }
+
     std::string getTargetPrefix() {
       switch (target_lang) {
         case Language::Vivado:
@@ -317,6 +352,17 @@ class CompilerOptions {
       getOptionAsString(multiple_pixels, pixels_per_thread);
       llvm::errs() << "\n  Vectorization of kernels: ";
       getOptionAsString(vectorize_kernels);
+      if (target_lang == Language::C99) {
+        llvm::errs() << "\n  Multithreaded execution of CPU kernels: ";
+        getOptionAsString(cpu_threads, cpu_threads_num);
+        llvm::errs() << "\n  Vector width of CPU kernels: ";
+        if (cpu_vector_bits) llvm::errs() << cpu_vector_bits << " bits";
+        else llvm::errs() << "AUTO - vector registers of the C/C++ target";
+        llvm::errs() << "\n  Zero-copy images: ";
+        getOptionAsString(cpu_zero_copy);
+        llvm::errs() << "\n  Fusion of producer/consumer kernels: ";
+        getOptionAsString(fuse_kernels);
+      }
       llvm::errs() << "\n\n";
     }
 };
@@ -76,10 +76,18 @@ enum class Reduce : uint8_t {
   MEDIAN
 };
 
-// interpolation modes for accessors
+// impulse responses of recursive filters
+enum class Recursive : uint8_t {
+  GAUSSIAN = 0,
+  EXPONENTIAL
+};
+
+// interpolation modes for accessors; RS resamples the iteration space like
+// NN, but keeps local operator offsets at the resolution of the Accessor
 enum class Interpolate : uint8_t {
   NO = 0,
   NN,
+  RS,
   LF,
   CF,
   L3
@@ -538,7 +546,10 @@ class HipaccKernelFeatures : public HipaccDevice {
         }
       }
 
-      if (acc->getSizeX() * acc->getSizeY() >= local_memory_threshold)
+      // local memory stages the tile of the iteration space, which does not
+      // match the pixels read by resampling Accessors
+      if (acc->getSizeX() * acc->getSizeY() >= local_memory_threshold &&
+          acc->getInterpolationMode() != Interpolate::RS)
         mem_type = static_cast<MemoryType>(mem_type|Local);
 
       memMap[acc] = mem_type;
@@ -593,6 +604,9 @@ class HipaccKernel : public HipaccKernelFeatures {
     SmallVector<FieldDecl *, 16> deviceArgFields;
     SmallVector<FunctionDecl *, 16> deviceFuncs;
     std::set<std::string> usedVars;
+    bool fused, line_buffered;
+    std::map<HipaccAccessor *, HipaccKernel *> fusedMap;
+    SmallVector<HipaccKernel *, 4> fusedKernels;
     unsigned max_threads_for_kernel;
     unsigned max_size_x, max_size_y;
     unsigned max_size_x_undef, max_size_y_undef;
@@ -632,6 +646,10 @@ class HipaccKernel : public HipaccKernelFeatures {
       deviceArgNames(),
       deviceArgFields(),
       deviceFuncs(),
+      fused(false),
+      line_buffered(false),
+      fusedMap(),
+      fusedKernels(),
       max_threads_for_kernel(0),
       max_size_x(0), max_size_y(0),
       max_size_x_undef(0), max_size_y_undef(0),
@@ -683,6 +701,41 @@ class HipaccKernel : public HipaccKernelFeatures {
     void addFunctionCall(FunctionDecl *FD) { deviceFuncs.push_back(FD); }
     ArrayRef<FunctionDecl *> getFunctionCalls() { return deviceFuncs; }
 
+    // kernel fusion: fused kernels are computed per pixel within the kernels
+    // reading their output image
+    void setFused() { fused = true; }
+    bool isFused() const { return fused; }
+    std::string getPixelName() const { return kernelName + "Pixel"; }
+    std::string getLineName() const { return kernelName + "Line"; }
+    std::string getEpochName() const { return kernelName + "Epoch"; }
+    void addFusedKernel(HipaccAccessor *Acc, HipaccKernel *K) {
+      fusedMap[Acc] = K;
+      if (std::find(fusedKernels.begin(), fusedKernels.end(), K) ==
+          fusedKernels.end())
+        fusedKernels.push_back(K);
+    }
+    HipaccKernel *getFusedKernel(HipaccAccessor *Acc) {
+      auto iter = fusedMap.find(Acc);
+      if (iter == fusedMap.end())
+        return nullptr;
+      return iter->second;
+    }
+    ArrayRef<HipaccKernel *> getFusedKernels() { return fusedKernels; }
+    // separable convolutions compute the row pass into line buffers and median
+    // filters slide histograms along rows, which are invalidated per execution
+    // (epoch) of the kernel
+    void setLineBuffered() { line_buffered = true; }
+    bool isLineBuffered() const { return line_buffered; }
+    // C/C++: kernels on pyramid levels are launched as tasks and may be
+    // deferred; kernels reading epoch counters of line buffers run in order
+    // with the host, which increments the counters
+    bool isTask() {
+      return iterationSpace->getBC()->isPyramid() && !line_buffered &&
+             fusedKernels.empty();
+    }
+    void getFusedArgs(std::string prefix,
+        SmallVectorImpl<std::pair<QualType, std::string>> &args);
+
     HipaccIterationSpace *getIterationSpace() { return iterationSpace; }
 
     void insertMapping(FieldDecl *decl, HipaccIterationSpace *iter) {
@@ -54,6 +54,8 @@ class HipaccDeviceOptions {
   public:
     unsigned alignment;
     unsigned local_memory_threshold;
+    unsigned unroll_threshold;
+    unsigned unroll_factor;
     unsigned default_num_threads_x;
     unsigned default_num_threads_y;
     unsigned pixels_per_thread[NumOperatorTypes];
@@ -62,12 +64,18 @@ class HipaccDeviceOptions {
 
   public:
     explicit HipaccDeviceOptions(CompilerOptions &options) :
+      unroll_threshold(225),
+      unroll_factor(4),
       default_num_threads_x(128),
       default_num_threads_y(1)
     {
       switch (options.getTargetDevice()) {
         case Device::CPU:
-          alignment = 8;
+          // cache line
+          alignment = 64;
+          // Masks/Domains larger than 15x15 are iterated in loops
+          unroll_threshold = 225;
+          unroll_factor = 8;
           break;
         case Device::Fermi_20:
         case Device::Fermi_21:
@@ -94,6 +102,7 @@ class HipaccDeviceOptions {
           require_textures[GlobalOperator] = Texture::None;
           require_textures[UserOperator] = Texture::Linear1D;
           vectorization = false;
+          unroll_threshold = 289;
           break;
         case Device::Evergreen:
           alignment = 1024;
@@ -122,6 +131,7 @@ class HipaccDeviceOptions {
         case Device::Midgard:
           alignment = 512;
           local_memory_threshold = 9999;
+          unroll_threshold = 81;
           default_num_threads_x = 4;
           pixels_per_thread[PointOperator] = 1;
           pixels_per_thread[LocalOperator] = 1;
@@ -59,6 +59,9 @@ class CreateHostStrings {
       indent = std::string(cur_indent, ' ');
     }
 
+    void writeFusedKernelArgs(HipaccKernel *K, std::string &resultStr);
+    void writeKernelImages(HipaccKernel *K, bool write, std::string &resultStr);
+
   public:
     CreateHostStrings(CompilerOptions &options, HipaccDevice &device) :
       options(options),
@@ -95,7 +98,8 @@ class CreateHostStrings {
         std::string function_name, std::string type_suffix, Interpolate ip_mode,
         Boundary bh_mode);
     void writePyramidAllocation(std::string pyrName, std::string type,
-        std::string img, std::string depth, std::string &resultStr);
+        std::string img, std::string depth, std::string temporary,
+        std::string &resultStr);
 };
 } // namespace hipacc
 } // namespace clang
@@ -404,6 +404,12 @@ WhileStmt *createWhileStmt(ASTContext &Ctx, VarDecl *Var, Expr *Cond, Stmt
 }
 
 
+AttributedStmt *createAttributedStmt(ASTContext &Ctx, ArrayRef<const Attr *>
+    Attrs, Stmt *SubStmt) {
+  return AttributedStmt::Create(Ctx, SourceLocation(), Attrs, SubStmt);
+}
+
+
 UnaryOperator *createUnaryOperator(ASTContext &Ctx, Expr *input,
     UnaryOperator::Opcode opc, QualType type) {
   return new (Ctx) UnaryOperator(input, opc, type, VK_RValue, OK_Ordinary,
@@ -221,19 +221,66 @@ void ASTTranslate::initCPU(SmallVector<Stmt *, 16> &kernelBody, Stmt *S) {
     }
   }
 
+  if (Kernel->isFused()) {
+    //
+    // T _pixel;
+    // body
+    // return _pixel;
+    //
+    // gid_x and gid_y are parameters of the per-pixel function; border
+    // handling is required for all pixels. The width of the iteration space
+    // is required to compute whole rows into line buffers
+    getWidthDecl(Kernel->getIterationSpace());
+    VarDecl *output = createVarDecl(Ctx, kernelDecl, "_pixel",
+        Kernel->getIterationSpace()->getImage()->getType());
+    DC->addDecl(output);
+    retValRef = createDeclRefExpr(Ctx, output);
+    kernelBody.push_back(createDeclStmt(Ctx, output));
+
+    Stmt *new_body = Clone(S);
+    assert(isa<CompoundStmt>(new_body) && "CompoundStmt for kernel function body expected!");
+    kernelBody.push_back(new_body);
+    kernelBody.push_back(createReturnStmt(Ctx, retValRef));
+    return;
+  }
+
   if (compilerOptions.emitVivado()) {
     // retValRef: Variable storing output value to return from kernel
     VarDecl *output = createVarDecl(Ctx, kernelDecl, "DummyOutputVal",
         Kernel->getIterationSpace()->getImage()->getType());
     retValRef = createDeclRefExpr(Ctx, output);
-  }
-  // convert the function body to kernel syntax
-  Stmt *new_body = Clone(S);
-  assert(isa<CompoundStmt>(new_body) && "CompoundStmt for kernel function body expected!");
 
-  if (compilerOptions.emitVivado()) {
+    // convert the function body to kernel syntax
+    Stmt *new_body = Clone(S);
+    assert(isa<CompoundStmt>(new_body) && "CompoundStmt for kernel function body expected!");
     kernelBody.push_back(new_body);
-  } else {
+    return;
+  }
+
+  Expr *lower_x = createIntegerLiteral(Ctx, 0);
+  Expr *lower_y = createIntegerLiteral(Ctx, 0);
+  Expr *upper_x = getWidthDecl(Kernel->getIterationSpace());
+  Expr *upper_y = getHeightDecl(Kernel->getIterationSpace());
+  if (Kernel->getIterationSpace()->getOffsetXDecl()) {
+    lower_x = getOffsetXDecl(Kernel->getIterationSpace());
+    upper_x = createBinaryOperator(Ctx, upper_x, lower_x, BO_Add, Ctx.IntTy);
+  }
+  if (Kernel->getIterationSpace()->getOffsetYDecl()) {
+    lower_y = getOffsetYDecl(Kernel->getIterationSpace());
+    upper_y = createBinaryOperator(Ctx, upper_y, lower_y, BO_Add, Ctx.IntTy);
+  }
+
+  // border handling is split off into separate loop nests; this is not
+  // possible for interpolated accessors since their index is scaled
+  bool split_border = bh_variant.borderVal;
+  for (auto img : KernelClass->getImgFields()) {
+    HipaccAccessor *Acc = Kernel->getImgFromMapping(img);
+    if (Acc->getBoundaryMode() != Boundary::UNDEFINED &&
+        Acc->getInterpolationMode() != Interpolate::NO)
+      split_border = false;
+  }
+
+  if (!split_border && !Kernel->vectorize()) {
     //
     // for (int gid_y=offset_y; gid_y<is_height+offset_y; gid_y++) {
     //     for (int gid_x=offset_x; gid_x<is_width+offset_x; gid_x++) {
@@ -241,16 +288,8 @@ void ASTTranslate::initCPU(SmallVector<Stmt *, 16> &kernelBody, Stmt *S) {
     //     }
     // }
     //
-    Expr *upper_x = getWidthDecl(Kernel->getIterationSpace());
-    Expr *upper_y = getHeightDecl(Kernel->getIterationSpace());
-    if (Kernel->getIterationSpace()->getOffsetXDecl()) {
-      upper_x = createBinaryOperator(Ctx, upper_x,
-          getOffsetXDecl(Kernel->getIterationSpace()), BO_Add, Ctx.IntTy);
-    }
-    if (Kernel->getIterationSpace()->getOffsetYDecl()) {
-      upper_y = createBinaryOperator(Ctx, upper_y,
-          getOffsetYDecl(Kernel->getIterationSpace()), BO_Add, Ctx.IntTy);
-    }
+    Stmt *new_body = Clone(S);
+    assert(isa<CompoundStmt>(new_body) && "CompoundStmt for kernel function body expected!");
     ForStmt *inner_loop = createForStmt(Ctx, gid_x_stmt, createBinaryOperator(Ctx,
           tileVars.global_id_x, upper_x, BO_LT, Ctx.BoolTy),
         createUnaryOperator(Ctx, tileVars.global_id_x, UO_PostInc,
@@ -261,7 +300,227 @@ void ASTTranslate::initCPU(SmallVector<Stmt *, 16> &kernelBody, Stmt *S) {
           tileVars.global_id_y->getType()), inner_loop);
 
     kernelBody.push_back(outer_loop);
+    return;
+  }
+
+  //
+  // int _bh_lo_x = offset_x + max_size_x/2, _bh_hi_x = ...;
+  // int _bh_lo_y = offset_y + max_size_y/2, _bh_hi_y = ...;
+  // int gid_y = offset_y;
+  // for (gid_y=offset_y; gid_y<_bh_lo_y; gid_y++)        top border
+  // for (gid_y=_bh_lo_y; gid_y<_bh_hi_y; gid_y++) {
+  //     int gid_x = offset_x;
+  //     for (gid_x=offset_x; gid_x<_bh_lo_x; gid_x++)    left border
+  //     for (gid_x=_bh_lo_x; gid_x<_bh_hi_x; gid_x++)    interior
+  //     (interior strip-mined to the SIMD width in case of vectorization)
+  //     for (gid_x=_bh_hi_x; gid_x<is_width+offset_x; gid_x++) right border
+  // }
+  // for (gid_y=_bh_hi_y; gid_y<is_height+offset_y; gid_y++) bottom border
+  //
+  border_variant border_variant_all = bh_variant;
+  unsigned interior_variant = 0;
+  if (!split_border) {
+    // no splitting possible: border handling for the whole iteration space
+    border_variant_all.borderVal = 0;
+    interior_variant = bh_variant.borderVal;
+  }
+
+  // interior bounds: lo = lower + size/2, hi = min(upper, lower + acc_size -
+  // size/2) for each accessor with border handling, clamped to lo <= hi
+  auto createInteriorBounds = [&] (bool split, StringRef suffix, Expr *lower,
+      Expr *upper, std::function<unsigned(HipaccAccessor *)> half_size,
+      std::function<DeclRefExpr *(HipaccAccessor *)> acc_size,
+      Expr *&lo, Expr *&hi) {
+    if (!split) {
+      lo = lower;
+      hi = upper;
+      return;
+    }
+
+    unsigned max_half = 0;
+    SmallVector<Stmt *, 16> hiStmts;
+    VarDecl *lo_decl = createVarDecl(Ctx, kernelDecl, "_bh_lo_" + suffix.str(),
+        Ctx.IntTy);
+    VarDecl *hi_decl = createVarDecl(Ctx, kernelDecl, "_bh_hi_" + suffix.str(),
+        Ctx.IntTy, upper);
+    DC->addDecl(lo_decl);
+    DC->addDecl(hi_decl);
+    lo = createDeclRefExpr(Ctx, lo_decl);
+    hi = createDeclRefExpr(Ctx, hi_decl);
+
+    for (auto img : KernelClass->getImgFields()) {
+      HipaccAccessor *Acc = Kernel->getImgFromMapping(img);
+      if (Acc->getBoundaryMode() == Boundary::UNDEFINED || !half_size(Acc))
+        continue;
+      max_half = std::max(max_half, half_size(Acc));
+
+      // if (_bh_hi > lower + acc_size - size/2) _bh_hi = ...;
+      Expr *bound = createBinaryOperator(Ctx, createBinaryOperator(Ctx, lower,
+            acc_size(Acc), BO_Add, Ctx.IntTy), createIntegerLiteral(Ctx,
+              static_cast<int32_t>(half_size(Acc))), BO_Sub, Ctx.IntTy);
+      hiStmts.push_back(createIfStmt(Ctx, createBinaryOperator(Ctx, hi, bound,
+              BO_GT, Ctx.BoolTy), createBinaryOperator(Ctx, hi, bound,
+                BO_Assign, Ctx.IntTy)));
+    }
+    lo_decl->setInit(createBinaryOperator(Ctx, lower, createIntegerLiteral(Ctx,
+            static_cast<int32_t>(max_half)), BO_Add, Ctx.IntTy));
+
+    kernelBody.push_back(createDeclStmt(Ctx, lo_decl));
+    kernelBody.push_back(createDeclStmt(Ctx, hi_decl));
+    for (auto stmt : hiStmts)
+      kernelBody.push_back(stmt);
+    // if (_bh_lo > upper) _bh_lo = upper;
+    kernelBody.push_back(createIfStmt(Ctx, createBinaryOperator(Ctx, lo, upper,
+            BO_GT, Ctx.BoolTy), createBinaryOperator(Ctx, lo, upper, BO_Assign,
+              Ctx.IntTy)));
+    // if (_bh_hi < _bh_lo) _bh_hi = _bh_lo;
+    kernelBody.push_back(createIfStmt(Ctx, createBinaryOperator(Ctx, hi, lo,
+            BO_LT, Ctx.BoolTy), createBinaryOperator(Ctx, hi, lo, BO_Assign,
+              Ctx.IntTy)));
+  };
+
+  Expr *lo_x, *hi_x, *lo_y, *hi_y;
+  createInteriorBounds(border_variant_all.borders.left, "x", lower_x, upper_x,
+      [] (HipaccAccessor *Acc) { return Acc->getSizeX()/2; },
+      [&] (HipaccAccessor *Acc) { return getWidthDecl(Acc); }, lo_x, hi_x);
+  createInteriorBounds(border_variant_all.borders.top, "y", lower_y, upper_y,
+      [] (HipaccAccessor *Acc) { return Acc->getSizeY()/2; },
+      [&] (HipaccAccessor *Acc) { return getHeightDecl(Acc); }, lo_y, hi_y);
+
+  // for (gid = lower; gid < upper; gid++) body
+  auto createLoop = [&] (DeclRefExpr *gid, Expr *lower, Expr *upper,
+      Stmt *body) -> ForStmt * {
+    return createForStmt(Ctx, createBinaryOperator(Ctx, gid, lower, BO_Assign,
+          gid->getType()), createBinaryOperator(Ctx, gid, upper, BO_LT,
+            Ctx.BoolTy), createUnaryOperator(Ctx, gid, UO_PostInc,
+            gid->getType()), body);
+  };
+  // clone the kernel body for the given border handling variant
+  auto cloneBody = [&] (unsigned borderVal) -> Stmt * {
+    // clear all stored decls before cloning, otherwise existing VarDecls
+    // will be reused and we will miss declarations
+    KernelDeclMap.clear();
+    bh_variant.borderVal = borderVal;
+    Stmt *new_body = Clone(S);
+    assert(isa<CompoundStmt>(new_body) && "CompoundStmt for kernel function body expected!");
+    return new_body;
+  };
+  // body of a row loop: declaration of gid_x followed by the column loops
+  auto createRow = [&] (SmallVector<Stmt *, 4> loops) -> Stmt * {
+    SmallVector<Stmt *, 4> rowBody;
+    rowBody.push_back(gid_x_stmt);
+    rowBody.append(loops.begin(), loops.end());
+    return createCompoundStmt(Ctx, rowBody);
+  };
+
+  kernelBody.push_back(gid_y_stmt);
+
+  // top border: all border variants
+  if (border_variant_all.borders.top) {
+    kernelBody.push_back(createLoop(tileVars.global_id_y, lower_y, lo_y,
+          createRow({ createLoop(tileVars.global_id_x, lower_x, upper_x,
+              cloneBody(border_variant_all.borderVal)) })));
+  }
+
+  // interior rows: left/right border and interior
+  border_variant row_variant = border_variant_all;
+  row_variant.borders.top = 0;
+  row_variant.borders.bottom = 0;
+  SmallVector<Stmt *, 4> rowLoops;
+  if (row_variant.borders.left) {
+    rowLoops.push_back(createLoop(tileVars.global_id_x, lower_x, lo_x,
+          cloneBody(row_variant.borderVal)));
+  }
+  if (Kernel->vectorize()) {
+    // ignore memory dependencies that cannot be proven by the compiler only
+    // if input and output images are distinct: the kernel does not read its
+    // output image, and no fused kernels or line buffers carry state from
+    // pixel to pixel; accessor parameters are declared __restrict__
+    HipaccImage *Out = Kernel->getIterationSpace()->getImage();
+    bool safe = Kernel->getFusedKernels().empty() && !Kernel->isLineBuffered();
+    for (auto img : KernelClass->getImgFields()) {
+      if (Kernel->getImgFromMapping(img)->getImage() == Out)
+        safe = false;
+    }
+
+    // strip-mine the row to whole vectors of the width specified by the user,
+    // or of the vector register width of the target (HIPACC_CPU_VECTOR_BYTES)
+    QualType QT = Out->getType();
+    int64_t pixel_size = Ctx.getTypeSizeInChars(QT).getQuantity();
+    Expr *lanes = nullptr;
+    if (compilerOptions.getCPUVectorBits()) {
+      if (compilerOptions.getCPUVectorBits() / 8 > pixel_size)
+        lanes = createIntegerLiteral(Ctx, static_cast<int32_t>(
+              compilerOptions.getCPUVectorBits() / 8 / pixel_size));
+    } else if (pixel_size < 16) {
+      // the runtime macro is referenced by name and expanded by the C/C++
+      // compiler, so the width is a constant expression also within pragmas
+      VarDecl *vector_bytes = createVarDecl(Ctx, kernelDecl,
+          "HIPACC_CPU_VECTOR_BYTES", Ctx.IntTy);
+      lanes = createParenExpr(Ctx, createBinaryOperator(Ctx,
+            createDeclRefExpr(Ctx, vector_bytes), createIntegerLiteral(Ctx,
+              static_cast<int32_t>(pixel_size)), BO_Div, Ctx.IntTy));
+    }
+
+    if (lanes) {
+      // vector loop of whole vectors at a fixed width: Clang loop hints for
+      // Clang, OpenMP simd for other compilers if dependencies are ignored
+      SmallVector<const Attr *, 2> simdHints;
+      simdHints.push_back(LoopHintAttr::CreateImplicit(Ctx,
+            LoopHintAttr::Pragma_clang_loop, LoopHintAttr::Vectorize, safe ?
+            LoopHintAttr::AssumeSafety : LoopHintAttr::Enable, nullptr));
+      simdHints.push_back(LoopHintAttr::CreateImplicit(Ctx,
+            LoopHintAttr::Pragma_clang_loop, LoopHintAttr::VectorizeWidth,
+            LoopHintAttr::Numeric, lanes));
+
+      // int _simd_hi_x = _bh_lo_x + (_bh_hi_x - _bh_lo_x) / lanes * lanes;
+      VarDecl *simd_hi_decl = createVarDecl(Ctx, kernelDecl, "_simd_hi_x",
+          Ctx.IntTy, createBinaryOperator(Ctx, lo_x, createBinaryOperator(Ctx,
+              createBinaryOperator(Ctx, createParenExpr(Ctx,
+                  createBinaryOperator(Ctx, hi_x, lo_x, BO_Sub, Ctx.IntTy)),
+                lanes, BO_Div, Ctx.IntTy), lanes, BO_Mul, Ctx.IntTy), BO_Add,
+            Ctx.IntTy));
+      DC->addDecl(simd_hi_decl);
+      DeclRefExpr *simd_hi_x = createDeclRefExpr(Ctx, simd_hi_decl);
+      rowLoops.push_back(createDeclStmt(Ctx, simd_hi_decl));
+
+      rowLoops.push_back(createAttributedStmt(Ctx, simdHints,
+            createLoop(tileVars.global_id_x, lo_x, simd_hi_x,
+              cloneBody(interior_variant))));
+
+      // scalar remainder loop of less than one vector
+      const Attr *scalarHints[] = {
+        LoopHintAttr::CreateImplicit(Ctx, LoopHintAttr::Pragma_clang_loop,
+            LoopHintAttr::Vectorize, LoopHintAttr::Disable, nullptr)
+      };
+      rowLoops.push_back(createAttributedStmt(Ctx, scalarHints,
+            createLoop(tileVars.global_id_x, simd_hi_x, hi_x,
+              cloneBody(interior_variant))));
+    } else {
+      // pixels as wide as a vector register: nothing to widen
+      rowLoops.push_back(createLoop(tileVars.global_id_x, lo_x, hi_x,
+            cloneBody(interior_variant)));
+    }
+  } else {
+    rowLoops.push_back(createLoop(tileVars.global_id_x, lo_x, hi_x,
+          cloneBody(interior_variant)));
   }
+  if (row_variant.borders.right) {
+    rowLoops.push_back(createLoop(tileVars.global_id_x, hi_x, upper_x,
+          cloneBody(row_variant.borderVal)));
+  }
+  kernelBody.push_back(createLoop(tileVars.global_id_y, lo_y, hi_y,
+        createRow(rowLoops)));
+
+  // bottom border: all border variants
+  if (border_variant_all.borders.bottom) {
+    kernelBody.push_back(createLoop(tileVars.global_id_y, hi_y, upper_y,
+          createRow({ createLoop(tileVars.global_id_x, lower_x, upper_x,
+              cloneBody(border_variant_all.borderVal)) })));
+  }
+
+  // reset image border configuration
+  bh_variant.borderVal = 0;
 }
 
 
@@ -666,14 +925,20 @@ Stmt *ASTTranslate::Hipacc(Stmt *S) {
     }
   }
 
+  // infer value ranges of integer variables to reduce their bit width
+  if (compilerOptions.emitC99() || compilerOptions.emitOpenCLFPGA() ||
+      compilerOptions.emitVivado())
+    inferValueIntervals(S);
+
   // initialize target-specific variables and add gid_x and gid_y declarations
   // to kernel body
   DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
   SmallVector<Stmt *, 16> kernelBody;
-  FunctionDecl *barrier;
+  FunctionDecl *barrier = nullptr;
   switch (compilerOptions.getTargetLang()) {
     case Language::Vivado:
     case Language::C99:
+      addRangeTables(S, kernelBody);
       initCPU(kernelBody, S);
       return createCompoundStmt(Ctx, kernelBody);
       break;
@@ -698,6 +963,7 @@ Stmt *ASTTranslate::Hipacc(Stmt *S) {
       initRenderscript(kernelBody);
       break;
   }
+  addRangeTables(S, kernelBody, barrier);
   lidYRef = tileVars.local_id_y;
   gidYRef = tileVars.global_id_y;
 
@@ -1407,6 +1673,14 @@ VarDecl *ASTTranslate::CloneVarDecl(VarDecl *VD) {
       TInfo = Ctx.getTrivialTypeSourceInfo(QT);
     }
 
+    // narrow integer variables according to their value range
+    auto interval = varIntervals.find(VD);
+    if (interval != varIntervals.end() && !escapingVars.count(VD) &&
+        getIntervalType(interval->second, QT) != QT) {
+      QT = getIntervalType(interval->second, QT);
+      TInfo = Ctx.getTrivialTypeSourceInfo(QT);
+    }
+
     DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
     result = VarDecl::Create(Ctx, DC, VD->getInnerLocStart(), VD->getLocation(),
         &Ctx.Idents.get(name), QT, TInfo, VD->getStorageClass());
@@ -1419,6 +1693,10 @@ VarDecl *ASTTranslate::CloneVarDecl(VarDecl *VD) {
     }
     result->setInitStyle(VD->getInitStyle());
     result->setTSCSpec(VD->getTSCSpec());
+    // inferred bit width is looked up for references to the clone
+    auto mask = bwInferred.find(VD);
+    if (mask != bwInferred.end())
+      bwInferred[result] = mask->second;
 
     // store mapping between original VarDecl and cloned VarDecl
     if (convMask || !redDomains.empty()) {
@@ -1847,7 +2125,7 @@ Expr *ASTTranslate::VisitCompoundAssignOperatorTranslate(CompoundAssignOperator
   setExprPropsClone(E, result);
 
   // convert: 'var += x' to 'var = var + x' if 'var' has reduced bit width
-  if (compilerOptions.emitOpenCLFPGA() &&
+  if ((compilerOptions.emitOpenCLFPGA() || compilerOptions.emitVivado()) &&
       result != nullptr && isa<CompoundAssignOperator>(result)) {
     CompoundAssignOperator *CAOE = dyn_cast<CompoundAssignOperator>(result);
     enum BinaryOperatorKind op = CAOE->getOpcode();
@@ -1865,7 +2143,8 @@ Expr *ASTTranslate::VisitCompoundAssignOperatorTranslate(CompoundAssignOperator
       if (SL.isValid()) {
         lineNum = Ctx.getFullLoc(SL).getExpansionLineNumber();
       }
-      mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString());
+      mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString(),
+          DRE->getDecl());
 
       if (mask != 0) {
         // bit width for 'var' reduction has been specified, apply conversion
@@ -2068,7 +2347,7 @@ Expr *ASTTranslate::VisitBinaryOperatorTranslate(BinaryOperator *E) {
   }
 
   // apply bit width reduction
-  if (compilerOptions.emitOpenCLFPGA() &&
+  if ((compilerOptions.emitOpenCLFPGA() || compilerOptions.emitVivado()) &&
       result != nullptr && isa<BinaryOperator>(result)) {
     BinaryOperator *BOE = dyn_cast<BinaryOperator>(result);
     enum BinaryOperatorKind op = BOE->getOpcode();
@@ -2089,7 +2368,8 @@ Expr *ASTTranslate::VisitBinaryOperatorTranslate(BinaryOperator *E) {
         if (SL.isValid()) {
           lineNum = Ctx.getFullLoc(SL).getExpansionLineNumber();
         }
-        mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString());
+        mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString(),
+            DRE->getDecl());
 
         if (mask != 0) {
           RHS = maskBitwidth(RHS, mask);
@@ -2122,7 +2402,8 @@ Expr *ASTTranslate::VisitBinaryOperatorTranslate(BinaryOperator *E) {
         if (SL.isValid()) {
           lineNum = Ctx.getFullLoc(SL).getExpansionLineNumber();
         }
-        mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString());
+        mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString(),
+            DRE->getDecl());
         if (mask != 0) {
           LHS = maskBitwidth(LHS, mask);
           changed = true;
@@ -2138,7 +2419,8 @@ Expr *ASTTranslate::VisitBinaryOperatorTranslate(BinaryOperator *E) {
         if (SL.isValid()) {
           lineNum = Ctx.getFullLoc(SL).getExpansionLineNumber();
         }
-        mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString());
+        mask = getBitwidthMask(lineNum, DRE->getDecl()->getNameAsString(),
+            DRE->getDecl());
         if (mask != 0) {
           RHS = maskBitwidth(RHS, mask);
           changed = true;
@@ -2276,13 +2558,17 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
             "0 arguments for Mask operator() only allowed within"
             "convolution lambda-function.");
         // within convolute lambda-function
-        if (mask->isConstant()) {
+        if (mask->isConstant() && (convIdxXRef || convIdxYRef)) {
+          // coefficient table when iterating in loops
+          result = accessMaskTable(mask, getMaskIdx(convIdxX, convIdxXRef),
+              getMaskIdx(convIdxY, convIdxYRef));
+        } else if (mask->isConstant()) {
           // propagate constants
           result = Clone(mask->getInitExpr(convIdxX, convIdxY));
         } else {
           // access mask elements
-          Expr *midx_x = createIntegerLiteral(Ctx, convIdxX);
-          Expr *midx_y = createIntegerLiteral(Ctx, convIdxY);
+          Expr *midx_x = getMaskIdx(convIdxX, convIdxXRef);
+          Expr *midx_y = getMaskIdx(convIdxY, convIdxYRef);
 
           // set Mask as being used within Kernel
           Kernel->setUsed(FD->getNameAsString());
@@ -2331,13 +2617,18 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
                "Mask and Domain size must be equal.");
 
         // within reduce/iterate lambda-function
-        if (mask->isConstant()) {
+        if (mask->isConstant() && (redIdxXRef.back() || redIdxYRef.back())) {
+          // coefficient table when iterating in loops
+          result = accessMaskTable(mask, getMaskIdx(redIdxX.back(),
+                redIdxXRef.back()), getMaskIdx(redIdxY.back(),
+                redIdxYRef.back()));
+        } else if (mask->isConstant()) {
           // propagate constants
           result = Clone(mask->getInitExpr(redIdxX.back(), redIdxY.back()));
         } else {
           // access mask elements
-          Expr *midx_x = createIntegerLiteral(Ctx, redIdxX.back());
-          Expr *midx_y = createIntegerLiteral(Ctx, redIdxY.back());
+          Expr *midx_x = getMaskIdx(redIdxX.back(), redIdxXRef.back());
+          Expr *midx_y = getMaskIdx(redIdxY.back(), redIdxYRef.back());
 
           // set Mask as being used within Kernel
           Kernel->setUsed(FD->getNameAsString());
@@ -2479,6 +2770,7 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
 
     HipaccMask *Mask = nullptr;
     int mask_idx_x = 0, mask_idx_y = 0;
+    Expr *mask_ref_x = nullptr, *mask_ref_y = nullptr;
     switch (E->getNumArgs()) {
       default:
         assert(0 && "0, 1, or 2 arguments for Accessor operator() expected!\n");
@@ -2508,12 +2800,16 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
               "the Mask parameter of the convolve method.");
           mask_idx_x = convIdxX;
           mask_idx_y = convIdxY;
+          mask_ref_x = convIdxXRef;
+          mask_ref_y = convIdxYRef;
         } else {
           bool found = false;
           for (unsigned int i = 0; i < redDomains.size(); ++i) {
             if (redDomains[i] == Mask) {
               mask_idx_x = redIdxX[i];
               mask_idx_y = redIdxY[i];
+              mask_ref_x = redIdxXRef[i];
+              mask_ref_y = redIdxYRef[i];
               found = true;
               break;
             }
@@ -2528,10 +2824,10 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
         // 2: -> offset y
         Expr *offset_x, *offset_y;
         if (E->getNumArgs()==2) {
-          offset_x = createIntegerLiteral(Ctx,
-              mask_idx_x-static_cast<int>(Mask->getSizeX()/2));
-          offset_y = createIntegerLiteral(Ctx,
-              mask_idx_y-static_cast<int>(Mask->getSizeY()/2));
+          offset_x = getMaskIdx(mask_idx_x, mask_ref_x,
+              static_cast<int>(Mask->getSizeX()/2));
+          offset_y = getMaskIdx(mask_idx_y, mask_ref_y,
+              static_cast<int>(Mask->getSizeY()/2));
         } else {
           offset_x = Clone(E->getArg(1));
           offset_y = Clone(E->getArg(2));
@@ -2544,7 +2840,11 @@ Expr *ASTTranslate::VisitCXXOperatorCallExprTranslate(CXXOperatorCallExpr *E) {
         } else {
           switch (mem_acc) {
             case READ_ONLY:
-              if (bh_variant.borderVal && !compilerOptions.emitVivado()) {
+              // resampled Accessors require border handling everywhere
+              if ((bh_variant.borderVal ||
+                   (acc->getInterpolationMode() == Interpolate::RS &&
+                    acc->getBoundaryMode() != Boundary::UNDEFINED)) &&
+                  !compilerOptions.emitVivado()) {
                 return addBorderHandling(LHS, offset_x, offset_y, acc);
               }
               // fall through
@@ -2590,9 +2890,11 @@ Expr *ASTTranslate::VisitCXXMemberCallExprTranslate(CXXMemberCallExpr *E) {
 
     switch (compilerOptions.getTargetLang()) {
       case Language::Vivado:
-      case Language::C99:
         result = accessMem2DAt(LHS, idx_x, idx_y);
         break;
+      case Language::C99:
+        result = accessMemArrAt(LHS, getStrideDecl(acc), idx_x, idx_y);
+        break;
       case Language::CUDA:
         if (Kernel->useTextureMemory(acc) != Texture::None) {
           result = accessMemTexAt(LHS, acc, mem_acc, idx_x, idx_y);
@@ -2668,6 +2970,12 @@ Expr *ASTTranslate::VisitCXXMemberCallExprTranslate(CXXMemberCallExpr *E) {
           }
           // fall through
         case Language::C99:
+          if (Kernel->isFused()) {
+            // per-pixel function of fused kernels returns the output value
+            result = retValRef;
+            break;
+          }
+          // fall through
         case Language::CUDA:
         case Language::OpenCLACC:
         case Language::OpenCLCPU:
@@ -2760,12 +3068,12 @@ Expr *ASTTranslate::VisitCXXMemberCallExprTranslate(CXXMemberCallExpr *E) {
         if (ME->getMemberNameInfo().getAsString() == "x") {
           assert(isDomainValid && "Getting Domain reduction IDs is only allowed "
                                   "within reduction lambda-function.");
-          return createIntegerLiteral(Ctx, redIdxX[redDepth] -
+          return getMaskIdx(redIdxX[redDepth], redIdxXRef[redDepth],
               static_cast<int>(redDomains[redDepth]->getSizeX()/2));
         } else if (ME->getMemberNameInfo().getAsString() == "y") {
           assert(isDomainValid && "Getting Domain reduction IDs is only allowed "
                                   "within reduction lambda-function.");
-          return createIntegerLiteral(Ctx, redIdxY[redDepth] -
+          return getMaskIdx(redIdxY[redDepth], redIdxYRef[redDepth],
               static_cast<int>(redDomains[redDepth]->getSizeY()/2));
         } else if (ME->getMemberNameInfo().getAsString() == "size_x") {
           assert(mask->isConstant() && "Domain size x must be constant.");
@@ -2784,12 +3092,12 @@ Expr *ASTTranslate::VisitCXXMemberCallExprTranslate(CXXMemberCallExpr *E) {
         if (ME->getMemberNameInfo().getAsString() == "x") {
           assert(mask == convMask && "Getting Mask convolution IDs is only allowed "
                                      "allowed within convolution lambda-function.");
-          return createIntegerLiteral(Ctx, convIdxX -
+          return getMaskIdx(convIdxX, convIdxXRef,
               static_cast<int>(mask->getSizeX()/2));
         } else if (ME->getMemberNameInfo().getAsString() == "y") {
           assert(mask == convMask && "Getting Mask convolution IDs is only allowed "
                                      "allowed within convolution lambda-function.");
-          return createIntegerLiteral(Ctx, convIdxY -
+          return getMaskIdx(convIdxY, convIdxYRef,
               static_cast<int>(mask->getSizeY()/2));
         } else if (ME->getMemberNameInfo().getAsString() == "size_x") {
           assert(mask->isConstant() && "Mask size x must be constant.");
@@ -2824,7 +3132,8 @@ Expr *ASTTranslate::VisitCXXMemberCallExprTranslate(CXXMemberCallExpr *E) {
 }
 
 
-int ASTTranslate::getBitwidthMask(size_t lineNum, std::string varName) {
+int ASTTranslate::getBitwidthMask(size_t lineNum, std::string varName,
+    const ValueDecl *VD) {
   int mask = 0;
 
   auto it = bwMap.find(lineNum);
@@ -2838,6 +3147,12 @@ int ASTTranslate::getBitwidthMask(size_t lineNum, std::string varName) {
     mask = it2->second;
   }
 
+  // no annotation: use bit width from value range analysis
+  if (mask == 0 && VD) {
+    auto it3 = bwInferred.find(VD);
+    if (it3 != bwInferred.end()) mask = it3->second;
+  }
+
   return mask;
 }
 
@@ -0,0 +1,598 @@
+//
+// Copyright (c) 2013, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+//===--- BitWidth.cpp - Value Range Analysis for Bit Width Reduction ------===//
+//
+// This file implements an interval analysis of integer variables in kernels.
+// Value ranges are derived from the types of input pixels, the coefficients
+// of masks, and the operations in the kernel. They replace manual bit width
+// annotations ('#pragma hipacc bw(<id>,<num>)') on FPGA targets and narrow
+// integer variables to 16 bit on the CPU.
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "hipacc/AST/ASTTranslate.h"
+
+using namespace clang;
+using namespace hipacc;
+using namespace ASTNode;
+
+// bounds beyond which intervals are not tracked: 2^40
+static const double max_interval = 1099511627776.0;
+// passes over the kernel before growing intervals are widened to unknown
+static const unsigned max_interval_passes = 8;
+
+
+static ValueInterval getInterval(double lo, double hi) {
+  if (std::fabs(lo) > max_interval || std::fabs(hi) > max_interval)
+    return ValueInterval();
+  return ValueInterval(ValueInterval::Known, static_cast<int64_t>(lo),
+      static_cast<int64_t>(hi));
+}
+
+
+static ValueInterval joinIntervals(ValueInterval A, ValueInterval B) {
+  if (A.kind == ValueInterval::Empty) return B;
+  if (B.kind == ValueInterval::Empty) return A;
+  if (A.kind == ValueInterval::Unknown || B.kind == ValueInterval::Unknown)
+    return ValueInterval();
+  return ValueInterval(ValueInterval::Known, std::min(A.lo, B.lo),
+      std::max(A.hi, B.hi));
+}
+
+
+// number of bits required for the values 0 .. val
+static unsigned getBits(int64_t val) {
+  unsigned bits = 1;
+  while (bits < 62 && (int64_t(1) << bits) <= val) ++bits;
+  return bits;
+}
+
+
+// all values of an integer type
+static ValueInterval getTypeInterval(ASTContext &Ctx, QualType QT) {
+  if (QT->isBooleanType())
+    return ValueInterval(ValueInterval::Known, 0, 1);
+  if (!QT->isIntegerType() || Ctx.getTypeSize(QT) > 32)
+    return ValueInterval();
+
+  int64_t bits = Ctx.getTypeSize(QT);
+  if (QT->isSignedIntegerType())
+    return ValueInterval(ValueInterval::Known, -(int64_t(1) << (bits-1)),
+        (int64_t(1) << (bits-1)) - 1);
+  return ValueInterval(ValueInterval::Known, 0, (int64_t(1) << bits) - 1);
+}
+
+
+// conversion to integer type: values outside the type wrap around
+static ValueInterval castInterval(ASTContext &Ctx, ValueInterval I, QualType
+    QT) {
+  if (I.kind == ValueInterval::Empty) return I;
+  if (QT->isBooleanType())
+    return ValueInterval(ValueInterval::Known, 0, 1);
+  if (!QT->isIntegerType()) return ValueInterval();
+
+  ValueInterval T = getTypeInterval(Ctx, QT);
+  if (I.kind == ValueInterval::Known && (T.kind == ValueInterval::Unknown ||
+        (I.lo >= T.lo && I.hi <= T.hi)))
+    return I;
+  return T;
+}
+
+
+static ValueInterval applyBinaryOperator(BinaryOperatorKind op, ValueInterval
+    A, ValueInterval B) {
+  switch (op) {
+    default: break;
+    case BO_LT: case BO_GT: case BO_LE: case BO_GE: case BO_EQ: case BO_NE:
+    case BO_LAnd: case BO_LOr:
+      return ValueInterval(ValueInterval::Known, 0, 1);
+  }
+
+  if (A.kind == ValueInterval::Empty || B.kind == ValueInterval::Empty)
+    return ValueInterval(ValueInterval::Empty);
+  if (A.kind == ValueInterval::Unknown || B.kind == ValueInterval::Unknown)
+    return ValueInterval();
+
+  double alo = A.lo, ahi = A.hi, blo = B.lo, bhi = B.hi;
+  switch (op) {
+    default:
+      return ValueInterval();
+    case BO_Comma:
+      return B;
+    case BO_Add:
+    case BO_AddAssign:
+      return getInterval(alo + blo, ahi + bhi);
+    case BO_Sub:
+    case BO_SubAssign:
+      return getInterval(alo - bhi, ahi - blo);
+    case BO_Mul:
+    case BO_MulAssign: {
+      double c[4] = { alo*blo, alo*bhi, ahi*blo, ahi*bhi };
+      return getInterval(*std::min_element(c, c+4), *std::max_element(c,
+            c+4));
+    }
+    case BO_Div:
+    case BO_DivAssign: {
+      if (blo <= 0 && bhi >= 0) return ValueInterval();
+      double c[4] = { std::trunc(alo/blo), std::trunc(alo/bhi),
+                      std::trunc(ahi/blo), std::trunc(ahi/bhi) };
+      return getInterval(*std::min_element(c, c+4), *std::max_element(c,
+            c+4));
+    }
+    case BO_Rem:
+    case BO_RemAssign: {
+      if (blo <= 0 && bhi >= 0) return ValueInterval();
+      double m = std::max(std::fabs(blo), std::fabs(bhi)) - 1;
+      return getInterval(alo >= 0 ? 0 : std::max(alo, -m),
+                         ahi <= 0 ? 0 : std::min(ahi, m));
+    }
+    case BO_Shl:
+    case BO_ShlAssign:
+      if (alo < 0 || blo < 0 || bhi > 31) return ValueInterval();
+      return getInterval(std::ldexp(alo, static_cast<int>(blo)),
+                         std::ldexp(ahi, static_cast<int>(bhi)));
+    case BO_Shr:
+    case BO_ShrAssign:
+      if (blo < 0 || bhi > 31) return ValueInterval();
+      return getInterval(
+          std::floor(std::ldexp(alo, -static_cast<int>(alo >= 0 ? bhi : blo))),
+          std::floor(std::ldexp(ahi, -static_cast<int>(ahi >= 0 ? blo : bhi))));
+    case BO_And:
+    case BO_AndAssign:
+      if (alo >= 0 && blo >= 0) return getInterval(0, std::min(ahi, bhi));
+      if (alo >= 0) return getInterval(0, ahi);
+      if (blo >= 0) return getInterval(0, bhi);
+      return ValueInterval();
+    case BO_Or:
+    case BO_OrAssign:
+    case BO_Xor:
+    case BO_XorAssign:
+      if (alo < 0 || blo < 0) return ValueInterval();
+      return getInterval(0, std::ldexp(1.0, static_cast<int>(getBits(
+                std::max(A.hi, B.hi)))) - 1);
+  }
+}
+
+
+// variables used other than being read or assigned, e.g. bound to
+// references or passed by address
+static void collectEscapingVars(Stmt *S, llvm::SmallPtrSet<const VarDecl *,
+    16> &vars, bool use=false) {
+  if (!S) return;
+
+  if (auto DRE = dyn_cast<DeclRefExpr>(S)) {
+    if (auto VD = dyn_cast<VarDecl>(DRE->getDecl()))
+      if (!use) vars.insert(VD);
+    return;
+  }
+
+  // captures are references to the variables, check only the body
+  if (auto LE = dyn_cast<LambdaExpr>(S)) {
+    collectEscapingVars(LE->getBody(), vars);
+    return;
+  }
+
+  if (auto BO = dyn_cast<BinaryOperator>(S)) {
+    if (BO->isAssignmentOp()) {
+      collectEscapingVars(BO->getLHS(), vars, true);
+      collectEscapingVars(BO->getRHS(), vars);
+      return;
+    }
+  }
+
+  if (auto UO = dyn_cast<UnaryOperator>(S)) {
+    if (UO->isIncrementDecrementOp()) {
+      collectEscapingVars(UO->getSubExpr(), vars, true);
+      return;
+    }
+  }
+
+  bool sub_use = false;
+  if (auto ICE = dyn_cast<ImplicitCastExpr>(S))
+    sub_use = ICE->getCastKind() == CK_LValueToRValue;
+  if (isa<ParenExpr>(S))
+    sub_use = use;
+
+  for (auto child : S->children())
+    collectEscapingVars(child, vars, sub_use);
+}
+
+
+static void collectReturnStmts(Stmt *S, SmallVector<ReturnStmt *, 4>
+    &returns) {
+  if (!S || isa<LambdaExpr>(S)) return;
+
+  if (auto RS = dyn_cast<ReturnStmt>(S)) {
+    returns.push_back(RS);
+    return;
+  }
+
+  for (auto child : S->children())
+    collectReturnStmts(child, returns);
+}
+
+
+// compute value intervals of all integer variables: the intervals of all
+// values assigned to a variable are joined until a fixed point is reached
+void ASTTranslate::inferValueIntervals(Stmt *S) {
+  varIntervals.clear();
+  convIntervals.clear();
+  escapingVars.clear();
+  bwInferred.clear();
+
+  collectEscapingVars(S, escapingVars);
+
+  intervalWiden = false;
+  for (unsigned pass=0; ; ++pass) {
+    intervalChanged = false;
+    updateValueIntervals(S);
+    if (!intervalChanged) break;
+    if (pass == max_interval_passes) intervalWiden = true;
+  }
+
+  // bit widths for FPGA targets, passed on to the cloned variables
+  for (auto entry : varIntervals) {
+    const VarDecl *VD = entry.first;
+    if (escapingVars.count(VD)) continue;
+    int mask = getIntervalBitwidthMask(entry.second, VD->getType());
+    if (mask != 0) bwInferred[VD] = mask;
+  }
+}
+
+
+void ASTTranslate::joinVarInterval(VarDecl *VD, ValueInterval I) {
+  // values of escaping variables may change through references
+  if (!VD->isLocalVarDecl() || !VD->getType()->isIntegerType() ||
+      escapingVars.count(VD))
+    return;
+
+  auto it = varIntervals.find(VD);
+  ValueInterval old = it == varIntervals.end() ?
+    ValueInterval(ValueInterval::Empty) : it->second;
+  ValueInterval J = joinIntervals(old, castInterval(Ctx, I, VD->getType()));
+  if (J.kind == old.kind && J.lo == old.lo && J.hi == old.hi) return;
+
+  // intervals growing after several passes depend on loops
+  if (intervalWiden) J = ValueInterval();
+  varIntervals[VD] = J;
+  intervalChanged = true;
+}
+
+
+void ASTTranslate::updateValueIntervals(Stmt *S) {
+  if (!S) return;
+
+  if (auto LE = dyn_cast<LambdaExpr>(S)) {
+    updateValueIntervals(LE->getBody());
+    return;
+  }
+
+  if (auto DS = dyn_cast<DeclStmt>(S)) {
+    for (auto decl : DS->decls()) {
+      if (auto VD = dyn_cast<VarDecl>(decl)) {
+        if (!VD->getInit()) continue;
+        updateValueIntervals(VD->getInit());
+        joinVarInterval(VD, getValueInterval(VD->getInit()));
+      }
+    }
+    return;
+  }
+
+  if (auto BO = dyn_cast<BinaryOperator>(S)) {
+    if (BO->isAssignmentOp())
+      if (auto DRE = dyn_cast<DeclRefExpr>(BO->getLHS()->IgnoreParenImpCasts()))
+        if (auto VD = dyn_cast<VarDecl>(DRE->getDecl()))
+          joinVarInterval(VD, getValueInterval(BO));
+  }
+
+  if (auto UO = dyn_cast<UnaryOperator>(S)) {
+    if (UO->isIncrementDecrementOp())
+      if (auto DRE = dyn_cast<DeclRefExpr>(UO->getSubExpr()->IgnoreParens()))
+        if (auto VD = dyn_cast<VarDecl>(DRE->getDecl()))
+          joinVarInterval(VD, applyBinaryOperator(UO->isIncrementOp() ?
+                BO_Add : BO_Sub, getValueInterval(DRE),
+                ValueInterval(ValueInterval::Known, 1, 1)));
+  }
+
+  // convolutions which are not assigned to variables
+  if (auto MCE = dyn_cast<CXXMemberCallExpr>(S))
+    getValueInterval(MCE);
+
+  for (auto child : S->children())
+    updateValueIntervals(child);
+}
+
+
+ValueInterval ASTTranslate::getValueInterval(Expr *E) {
+  E = E->IgnoreParens();
+  QualType QT = E->getType();
+
+  llvm::APSInt val;
+  if (QT->isIntegerType() && !isa<DeclRefExpr>(E) &&
+      E->isIntegerConstantExpr(val, Ctx)) {
+    if (val.getMinSignedBits() > 40) return ValueInterval();
+    return ValueInterval(ValueInterval::Known, val.getExtValue(),
+        val.getExtValue());
+  }
+
+  if (auto CE = dyn_cast<CastExpr>(E)) {
+    switch (CE->getCastKind()) {
+      case CK_LValueToRValue:
+      case CK_NoOp:
+        return getValueInterval(CE->getSubExpr());
+      case CK_IntegralCast:
+      case CK_IntegralToBoolean:
+        return castInterval(Ctx, getValueInterval(CE->getSubExpr()), QT);
+      default:
+        return castInterval(Ctx, ValueInterval(), QT);
+    }
+  }
+
+  if (auto DRE = dyn_cast<DeclRefExpr>(E)) {
+    if (auto ECD = dyn_cast<EnumConstantDecl>(DRE->getDecl()))
+      return ValueInterval(ValueInterval::Known,
+          ECD->getInitVal().getExtValue(), ECD->getInitVal().getExtValue());
+    auto VD = dyn_cast<VarDecl>(DRE->getDecl());
+    if (VD && VD->isLocalVarDecl() && !escapingVars.count(VD) &&
+        QT->isIntegerType()) {
+      auto it = varIntervals.find(VD);
+      if (it == varIntervals.end())
+        return ValueInterval(ValueInterval::Empty);
+      return it->second;
+    }
+    return castInterval(Ctx, ValueInterval(), QT);
+  }
+
+  // pixels of Accessors and coefficients of Masks
+  if (auto OCE = dyn_cast<CXXOperatorCallExpr>(E)) {
+    auto ME = dyn_cast<MemberExpr>(OCE->getArg(0));
+    FieldDecl *FD = ME ? dyn_cast<FieldDecl>(ME->getMemberDecl()) : nullptr;
+    if (FD)
+      if (HipaccMask *Mask = Kernel->getMaskFromMapping(FD))
+        return getMaskInterval(OCE, Mask);
+    return castInterval(Ctx, ValueInterval(), QT);
+  }
+
+  if (auto UO = dyn_cast<UnaryOperator>(E)) {
+    ValueInterval I = getValueInterval(UO->getSubExpr());
+    ValueInterval one(ValueInterval::Known, 1, 1);
+    switch (UO->getOpcode()) {
+      default:
+        I = ValueInterval();
+        break;
+      case UO_Plus:
+      case UO_PostInc:
+      case UO_PostDec:
+        break;
+      case UO_Minus:
+        I = applyBinaryOperator(BO_Sub, ValueInterval(ValueInterval::Known, 0,
+              0), I);
+        break;
+      case UO_Not:
+        // ~x = -x - 1
+        I = applyBinaryOperator(BO_Sub, ValueInterval(ValueInterval::Known,
+              -1, -1), I);
+        break;
+      case UO_LNot:
+        I = ValueInterval(ValueInterval::Known, 0, 1);
+        break;
+      case UO_PreInc:
+        I = applyBinaryOperator(BO_Add, I, one);
+        break;
+      case UO_PreDec:
+        I = applyBinaryOperator(BO_Sub, I, one);
+        break;
+    }
+    return castInterval(Ctx, I, QT);
+  }
+
+  if (auto BO = dyn_cast<BinaryOperator>(E)) {
+    if (BO->getOpcode() == BO_Assign)
+      return castInterval(Ctx, getValueInterval(BO->getRHS()), QT);
+    return castInterval(Ctx, applyBinaryOperator(BO->getOpcode(),
+          getValueInterval(BO->getLHS()), getValueInterval(BO->getRHS())), QT);
+  }
+
+  if (auto CO = dyn_cast<ConditionalOperator>(E))
+    return castInterval(Ctx, joinIntervals(getValueInterval(CO->getTrueExpr()),
+          getValueInterval(CO->getFalseExpr())), QT);
+
+  if (auto MCE = dyn_cast<CXXMemberCallExpr>(E)) {
+    if (MCE->getDirectCallee() && MCE->getImplicitObjectArgument() &&
+        isa<CXXThisExpr>(MCE->getImplicitObjectArgument()->IgnoreImpCasts()) &&
+        (MCE->getDirectCallee()->getName().equals("convolve") ||
+         MCE->getDirectCallee()->getName().equals("reduce")))
+      return getConvolutionInterval(MCE);
+    return castInterval(Ctx, ValueInterval(), QT);
+  }
+
+  if (auto CE = dyn_cast<CallExpr>(E)) {
+    FunctionDecl *FD = CE->getDirectCallee();
+    if (isMathFunction(FD) && CE->getNumArgs() &&
+        QT->isIntegerType()) {
+      ValueInterval A = getValueInterval(CE->getArg(0));
+      std::string name = FD->getNameAsString();
+      if ((name == "abs" || name == "labs") && A.kind ==
+          ValueInterval::Known)
+        return castInterval(Ctx, getInterval(A.lo >= 0 ? A.lo : A.hi <= 0 ?
+              -A.hi : 0, std::max(std::abs(A.lo), std::abs(A.hi))), QT);
+      if ((name == "min" || name == "max") && CE->getNumArgs() == 2) {
+        ValueInterval B = getValueInterval(CE->getArg(1));
+        if (A.kind == ValueInterval::Known && B.kind == ValueInterval::Known)
+          return castInterval(Ctx, name == "min" ?
+              getInterval(std::min(A.lo, B.lo), std::min(A.hi, B.hi)) :
+              getInterval(std::max(A.lo, B.lo), std::max(A.hi, B.hi)), QT);
+        return castInterval(Ctx, joinIntervals(A, B), QT);
+      }
+    }
+    return castInterval(Ctx, ValueInterval(), QT);
+  }
+
+  return castInterval(Ctx, ValueInterval(), QT);
+}
+
+
+// coefficient of a Mask: the current point when iterating over the Mask or
+// over a Domain of the same size, any coefficient otherwise
+ValueInterval ASTTranslate::getMaskInterval(CXXOperatorCallExpr *E,
+    HipaccMask *Mask) {
+  QualType QT = E->getType();
+  if (Mask->isDomain() || !QT->isIntegerType())
+    return castInterval(Ctx, ValueInterval(), QT);
+
+  if (!intervalCoeffs.count(Mask)) {
+    std::vector<double> coeffs;
+    if (!getMaskCoefficients(Mask, coeffs)) coeffs.clear();
+    intervalCoeffs[Mask] = coeffs;
+  }
+  std::vector<double> &coeffs = intervalCoeffs[Mask];
+  if (coeffs.empty())
+    return castInterval(Ctx, ValueInterval(), QT);
+
+  bool current = false;
+  if (intervalMask && E->getNumArgs() == 1) {
+    current = intervalMask == Mask;
+  } else if (intervalMask && E->getNumArgs() == 2) {
+    auto ME = dyn_cast<MemberExpr>(E->getArg(1)->IgnoreImpCasts());
+    FieldDecl *FD = ME ? dyn_cast<FieldDecl>(ME->getMemberDecl()) : nullptr;
+    current = FD && Kernel->getMaskFromMapping(FD) == intervalMask &&
+              intervalMask->getSizeX() == Mask->getSizeX() &&
+              intervalMask->getSizeY() == Mask->getSizeY();
+  }
+
+  if (current) {
+    double coeff = coeffs[intervalMaskY*Mask->getSizeX() + intervalMaskX];
+    return castInterval(Ctx, getInterval(coeff, coeff), QT);
+  }
+  return castInterval(Ctx, getInterval(*std::min_element(coeffs.begin(),
+          coeffs.end()), *std::max_element(coeffs.begin(), coeffs.end())), QT);
+}
+
+
+// result of convolve/reduce: the lambda-function is evaluated for each point
+// of the Mask/Domain; for sums, the interval of partial sums is stored for the
+// temporary variable accumulating the result
+ValueInterval ASTTranslate::getConvolutionInterval(CXXMemberCallExpr *E) {
+  QualType QT = E->getType();
+  if (E->getNumArgs() != 3)
+    return castInterval(Ctx, ValueInterval(), QT);
+
+  auto ME = dyn_cast<MemberExpr>(E->getArg(0)->IgnoreImpCasts());
+  FieldDecl *FD = ME ? dyn_cast<FieldDecl>(ME->getMemberDecl()) : nullptr;
+  HipaccMask *Mask = FD ? Kernel->getMaskFromMapping(FD) : nullptr;
+  auto MTE = dyn_cast<MaterializeTemporaryExpr>(E->getArg(2));
+  LambdaExpr *LE = MTE ? dyn_cast<LambdaExpr>(
+      MTE->GetTemporaryExpr()->IgnoreImpCasts()) : nullptr;
+  llvm::APSInt mode_val;
+  if (!Mask || !LE || !E->getArg(1)->isIntegerConstantExpr(mode_val, Ctx))
+    return castInterval(Ctx, ValueInterval(), QT);
+  Reduce mode = static_cast<Reduce>(mode_val.getZExtValue());
+
+  QualType RT = LE->getCallOperator()->getReturnType();
+  SmallVector<ReturnStmt *, 4> returns;
+  collectReturnStmts(LE->getBody(), returns);
+
+  HipaccMask *outerMask = intervalMask;
+  int outerX = intervalMaskX, outerY = intervalMaskY;
+  intervalMask = Mask;
+
+  ValueInterval result(ValueInterval::Empty);
+  double sum_lo = 0, sum_hi = 0, part_lo = 0, part_hi = 0;
+  for (size_t y=0; y<Mask->getSizeY(); ++y) {
+    for (size_t x=0; x<Mask->getSizeX(); ++x) {
+      if (Mask->isDomain() && Mask->isConstant() &&
+          !Mask->isDomainDefined(x, y))
+        continue;
+      intervalMaskX = x;
+      intervalMaskY = y;
+
+      ValueInterval I(ValueInterval::Empty);
+      for (auto ret : returns)
+        if (ret->getRetValue())
+          I = joinIntervals(I, castInterval(Ctx,
+                getValueInterval(ret->getRetValue()), RT));
+
+      if (I.kind == ValueInterval::Unknown || mode == Reduce::PROD) {
+        result = ValueInterval();
+        break;
+      }
+      if (I.kind == ValueInterval::Empty) continue;
+
+      result = joinIntervals(result, I);
+      sum_lo += I.lo;
+      sum_hi += I.hi;
+      part_lo += std::min<int64_t>(I.lo, 0);
+      part_hi += std::max<int64_t>(I.hi, 0);
+    }
+    if (result.kind == ValueInterval::Unknown) break;
+  }
+
+  intervalMask = outerMask;
+  intervalMaskX = outerX;
+  intervalMaskY = outerY;
+
+  if (mode == Reduce::SUM && result.kind == ValueInterval::Known) {
+    convIntervals[E] = castInterval(Ctx, getInterval(part_lo, part_hi), RT);
+    result = getInterval(sum_lo, sum_hi);
+  } else {
+    convIntervals.erase(E);
+  }
+
+  return castInterval(Ctx, result, QT);
+}
+
+
+// mask for values of a non-negative interval, 0 if no bits can be saved
+int ASTTranslate::getIntervalBitwidthMask(ValueInterval I, QualType QT) {
+  if (I.kind != ValueInterval::Known || I.lo < 0 || !QT->isIntegerType() ||
+      QT->isBooleanType())
+    return 0;
+
+  unsigned bits = getBits(I.hi);
+  if (bits >= Ctx.getTypeSize(QT) || bits >= 31) return 0;
+  return static_cast<int>((int64_t(1) << bits) - 1);
+}
+
+
+// 16-bit type for int variables on the CPU: twice the number of SIMD lanes
+// when loops over the iteration space are vectorized by the C compiler; the
+// arithmetic is still carried out in int due to integer promotion
+QualType ASTTranslate::getIntervalType(ValueInterval I, QualType QT) {
+  if (!compilerOptions.emitC99() || I.kind != ValueInterval::Known)
+    return QT;
+  if (!Ctx.hasSameType(QT.getUnqualifiedType(), Ctx.IntTy))
+    return QT;
+  if (I.lo < -32768 || I.hi > 32767)
+    return QT;
+
+  return Ctx.getQualifiedType(Ctx.ShortTy, QT.getQualifiers());
+}
+
+// vim: set ts=2 sw=2 sts=2 et ai:
@@ -182,6 +182,18 @@ Expr *ASTTranslate::addBorderHandling(DeclRefExpr *LHS, Expr *local_offset_x,
           createParenExpr(Ctx, addNNInterpolationY(Acc, idx_y)), nullptr,
           Ctx.getTrivialTypeSourceInfo(Ctx.IntTy));
       break;
+    case Interpolate::RS:
+      // resample gid_[x|y], but not the local offset:
+      // (int)(acc_scale_x * (gid_x - is_offset_x)) + local_offset_x
+      idx_x = addLocalOffset(createCStyleCastExpr(Ctx, Ctx.IntTy,
+            CK_FloatingToIntegral, createParenExpr(Ctx,
+              addNNInterpolationX(Acc, tileVars.global_id_x)), nullptr,
+            Ctx.getTrivialTypeSourceInfo(Ctx.IntTy)), local_offset_x);
+      idx_y = addLocalOffset(createCStyleCastExpr(Ctx, Ctx.IntTy,
+            CK_FloatingToIntegral, createParenExpr(Ctx,
+              addNNInterpolationY(Acc, gidYRef)), nullptr,
+            Ctx.getTrivialTypeSourceInfo(Ctx.IntTy)), local_offset_y);
+      break;
     case Interpolate::LF:
     case Interpolate::CF:
     case Interpolate::L3:
@@ -200,6 +212,14 @@ Expr *ASTTranslate::addBorderHandling(DeclRefExpr *LHS, Expr *local_offset_x,
     }
   }
 
+  // resampled Accessors may cross any border, independent of the position in
+  // the iteration space
+  bool resample = Acc->getInterpolationMode() == Interpolate::RS;
+  bool border_left = bh_variant.borders.left || resample;
+  bool border_right = bh_variant.borders.right || resample;
+  bool border_top = bh_variant.borders.top || resample;
+  bool border_bottom = bh_variant.borders.bottom || resample;
+
   // add temporary variables for updated idx_x and idx_y
   if (local_offset_x) {
     VarDecl *tmp_x = createVarDecl(Ctx, kernelDecl, gidx_str, Ctx.IntTy, idx_x);
@@ -230,28 +250,30 @@ Expr *ASTTranslate::addBorderHandling(DeclRefExpr *LHS, Expr *local_offset_x,
     bhCStmt.push_back(curCStmt);
 
     Expr *bo_constant = nullptr;
-    if (bh_variant.borders.right && local_offset_x) {
+    if (border_right && local_offset_x) {
       // < _gid_x<0> >= offset_x+width >
       bo_constant = constant_upper(Ctx, idx_x, upper_x, bo_constant);
     }
-    if (bh_variant.borders.bottom && local_offset_y) {
+    if (border_bottom && local_offset_y) {
       // if (_gid_y<0> >= offset_y+height)
       bo_constant = constant_upper(Ctx, idx_y, upper_y, bo_constant);
     }
-    if (bh_variant.borders.left && local_offset_x) {
+    if (border_left && local_offset_x) {
       // if (_gid_x<0> < offset_x)
       bo_constant = constant_lower(Ctx, idx_x, lower_x, bo_constant);
     }
-    if (bh_variant.borders.top && local_offset_y) {
+    if (border_top && local_offset_y) {
       // if (_gid_y<0> < offset_y)
       bo_constant = constant_lower(Ctx, idx_y, lower_y, bo_constant);
     }
 
     switch (compilerOptions.getTargetLang()) {
       case Language::Vivado:
-      case Language::C99:
           RHS = accessMem2DAt(LHS, idx_x, idx_y);
           break;
+      case Language::C99:
+          RHS = accessMemArrAt(LHS, getStrideDecl(Acc), idx_x, idx_y);
+          break;
       case Language::CUDA:
         if (Kernel->useTextureMemory(Acc) != Texture::None) {
           RHS = accessMemTexAt(LHS, Acc, READ_ONLY, idx_x, idx_y);
@@ -314,21 +336,21 @@ Expr *ASTTranslate::addBorderHandling(DeclRefExpr *LHS, Expr *local_offset_x,
     auto stride_x = getWidthDecl(Acc);
     auto stride_y = getHeightDecl(Acc);
     if (upper_fun) {
-      if (bh_variant.borders.right && local_offset_x) {
+      if (border_right && local_offset_x) {
         bhStmts.push_back(upper_fun(Ctx, idx_x, upper_x, stride_x));
         bhCStmt.push_back(curCStmt);
       }
-      if (bh_variant.borders.bottom && local_offset_y) {
+      if (border_bottom && local_offset_y) {
         bhStmts.push_back(upper_fun(Ctx, idx_y, upper_y, stride_y));
         bhCStmt.push_back(curCStmt);
       }
     }
     if (lower_fun) {
-      if (bh_variant.borders.left && local_offset_x) {
+      if (border_left && local_offset_x) {
         bhStmts.push_back(lower_fun(Ctx, idx_x, lower_x, stride_x));
         bhCStmt.push_back(curCStmt);
       }
-      if (bh_variant.borders.top && local_offset_y) {
+      if (border_top && local_offset_y) {
         bhStmts.push_back(lower_fun(Ctx, idx_y, lower_y, stride_y));
         bhCStmt.push_back(curCStmt);
       }
@@ -337,9 +359,11 @@ Expr *ASTTranslate::addBorderHandling(DeclRefExpr *LHS, Expr *local_offset_x,
     // get data
     switch (compilerOptions.getTargetLang()) {
       case Language::Vivado:
-      case Language::C99:
           result = accessMem2DAt(LHS, idx_x, idx_y);
           break;
+      case Language::C99:
+          result = accessMemArrAt(LHS, getStrideDecl(Acc), idx_x, idx_y);
+          break;
       case Language::CUDA:
         if (Kernel->useTextureMemory(Acc) != Texture::None) {
           result = accessMemTexAt(LHS, Acc, READ_ONLY, idx_x, idx_y);
@@ -31,6 +31,13 @@
 
 // includes for numeric_limits
 #include <limits>
+// includes for separability checks of masks
+#include <cmath>
+#include <vector>
+// includes for median selection networks
+#include <algorithm>
+
+#include <llvm/ADT/SmallPtrSet.h>
 
 #include "hipacc/AST/ASTTranslate.h"
 
@@ -38,6 +45,15 @@ using namespace clang;
 using namespace hipacc;
 using namespace ASTNode;
 
+// access array variable at given index: arr[idx]
+static Expr *accessArray(ASTContext &Ctx, DeclRefExpr *arr, Expr *idx) {
+  QualType QT = Ctx.getAsArrayType(arr->getType())->getElementType();
+  return new (Ctx) ArraySubscriptExpr(createImplicitCastExpr(Ctx,
+        Ctx.getPointerType(QT), CK_ArrayToPointerDecay, arr, nullptr,
+        VK_RValue), idx, QT, VK_LValue, OK_Ordinary, SourceLocation());
+}
+
+
 // create expression for convolutions
 Stmt *ASTTranslate::getConvolutionStmt(Reduce mode, DeclRefExpr *tmp_var,
     Expr *ret_val) {
@@ -90,8 +106,36 @@ Stmt *ASTTranslate::getConvolutionStmt(Reduce mode, DeclRefExpr *tmp_var,
         result = Clone(dyn_cast<Expr>(result));
       }
       break;
-    case Reduce::MEDIAN:
-      assert(0 && "Unsupported reduction mode.");
+    case Reduce::MEDIAN: {
+      // store value, the median is selected after the last iteration
+      assert(medianValues.count(tmp_var) && "median values not declared");
+      MedianValues &median = medianValues[tmp_var];
+      if (median.sliding) {
+        // hipaccAddHistogram(hist, val);
+        SmallVector<QualType, 2> argTypes;
+        SmallVector<std::string, 2> argNames;
+        SmallVector<Expr *, 2> args;
+        argTypes.push_back(median.values->getType());
+        argNames.push_back("hist");
+        args.push_back(median.values);
+        argTypes.push_back(tmp_var->getType());
+        argNames.push_back("val");
+        args.push_back(ret_val);
+        FunctionDecl *add = createFunctionDecl(Ctx,
+            Ctx.getTranslationUnitDecl(), "hipaccAddHistogram", Ctx.VoidTy,
+            argTypes, argNames);
+        result = createFunctionCall(Ctx, add, args);
+      } else if (median.histogram) {
+        // hist[val]++;
+        result = createUnaryOperator(Ctx, accessArray(Ctx, median.values,
+              ret_val), UO_PostInc, Ctx.UnsignedIntTy);
+      } else {
+        // med[idx] = val;
+        result = createBinaryOperator(Ctx, accessMedianValue(median,
+              median.index), ret_val, BO_Assign, tmp_var->getType());
+      }
+      break;
+    }
   }
 
   return result;
@@ -218,8 +262,8 @@ Stmt *ASTTranslate::addDomainCheck(HipaccMask *Domain, DeclRefExpr *domain_var,
     case Language::C99:
     case Language::CUDA:
       // array subscript: Domain[y][x]
-      dom_acc = accessMem2DAt(domain_var, createIntegerLiteral(Ctx,
-            redIdxX.back()), createIntegerLiteral(Ctx, redIdxY.back()));
+      dom_acc = accessMem2DAt(domain_var, getMaskIdx(redIdxX.back(),
+            redIdxXRef.back()), getMaskIdx(redIdxY.back(), redIdxYRef.back()));
       break;
     case Language::OpenCLACC:
     case Language::OpenCLCPU:
@@ -227,14 +271,15 @@ Stmt *ASTTranslate::addDomainCheck(HipaccMask *Domain, DeclRefExpr *domain_var,
     case Language::OpenCLGPU:
       // array subscript: Domain[y*width + x]
       dom_acc = accessMemArrAt(domain_var, createIntegerLiteral(Ctx,
-            static_cast<int>(Domain->getSizeX())), createIntegerLiteral(Ctx,
-            redIdxX.back()), createIntegerLiteral(Ctx, redIdxY.back()));
+            static_cast<int>(Domain->getSizeX())), getMaskIdx(redIdxX.back(),
+            redIdxXRef.back()), getMaskIdx(redIdxY.back(), redIdxYRef.back()));
       break;
     case Language::Renderscript:
     case Language::Filterscript:
       // allocation access: rsGetElementAt(Domain, x, y)
-      dom_acc = accessMemAllocAt(domain_var, READ_ONLY, createIntegerLiteral(Ctx,
-            redIdxX.back()), createIntegerLiteral(Ctx, redIdxY.back()));
+      dom_acc = accessMemAllocAt(domain_var, READ_ONLY, getMaskIdx(
+            redIdxX.back(), redIdxXRef.back()), getMaskIdx(redIdxY.back(),
+            redIdxYRef.back()));
       break;
   }
   // if (dom(x, y) > 0)
@@ -286,6 +331,1288 @@ bool ASTTranslate::searchForBreakIterate(Stmt *S) {
 }
 
 
+// evaluate the coefficients of a constant Mask, stored row by row
+bool ASTTranslate::getMaskCoefficients(HipaccMask *Mask,
+    std::vector<double> &coeffs) {
+  if (!Mask->isConstant())
+    return false;
+
+  QualType QT = Mask->getType();
+  if (!QT->isIntegerType() && !QT->isRealFloatingType())
+    return false;
+
+  coeffs.resize(Mask->getSizeX()*Mask->getSizeY());
+  for (size_t y=0; y<Mask->getSizeY(); ++y) {
+    for (size_t x=0; x<Mask->getSizeX(); ++x) {
+      Expr::EvalResult val;
+      if (!Mask->getInitExpr(x, y)->EvaluateAsRValue(val, Ctx))
+        return false;
+
+      double &coeff = coeffs[y*Mask->getSizeX() + x];
+      if (val.Val.isInt()) {
+        coeff = val.Val.getInt().getSExtValue();
+      } else if (val.Val.isFloat()) {
+        llvm::APFloat fval = val.Val.getFloat();
+        if (&fval.getSemantics() ==
+            (const llvm::fltSemantics*)&llvm::APFloat::IEEEsingle) {
+          coeff = fval.convertToFloat();
+        } else if (&fval.getSemantics() ==
+            (const llvm::fltSemantics*)&llvm::APFloat::IEEEdouble) {
+          coeff = fval.convertToDouble();
+        } else {
+          return false;
+        }
+      } else {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+// create literal for a Mask coefficient of the given type
+Expr *ASTTranslate::createCoefficient(QualType QT, double coeff) {
+  if (QT->isIntegerType())
+    return createIntegerLiteral(Ctx, static_cast<int32_t>(coeff));
+  if (QT->isSpecificBuiltinType(BuiltinType::Float))
+    return FloatingLiteral::Create(Ctx, llvm::APFloat(
+          static_cast<float>(coeff)), false, Ctx.FloatTy, SourceLocation());
+  return FloatingLiteral::Create(Ctx, llvm::APFloat(coeff), false,
+      Ctx.DoubleTy, SourceLocation());
+}
+
+
+// match lambda-function 'return mask() * Acc(mask);' of a convolution or
+// 'return Acc(dom);' of a reduction and return the Accessor call
+CXXOperatorCallExpr *ASTTranslate::getMaskProductAccess(LambdaExpr *LE,
+    HipaccMask *Mask) {
+  CompoundStmt *body = dyn_cast<CompoundStmt>(LE->getBody());
+  if (!body || body->size() != 1 || !isa<ReturnStmt>(body->body_back()))
+    return nullptr;
+  Expr *ret_val = dyn_cast<ReturnStmt>(body->body_back())->getRetValue();
+  QualType QT = LE->getCallOperator()->getReturnType();
+  if (!ret_val || !QT->isBuiltinType())
+    return nullptr;
+
+  // read-only Accessor call with the Mask as parameter
+  auto isMaskAccess = [&] (CXXOperatorCallExpr *OCE) {
+    if (OCE->getNumArgs() != 2 || !isa<MemberExpr>(OCE->getArg(0)))
+      return false;
+    MemberExpr *ME = dyn_cast<MemberExpr>(OCE->getArg(0));
+    FieldDecl *FD = dyn_cast<FieldDecl>(ME->getMemberDecl());
+    if (!FD || !Kernel->getImgFromMapping(FD) ||
+        KernelClass->getMemAccess(FD) != READ_ONLY)
+      return false;
+    auto MaskME = dyn_cast<MemberExpr>(OCE->getArg(1)->IgnoreImpCasts());
+    auto MaskFD = MaskME ? dyn_cast<FieldDecl>(MaskME->getMemberDecl()) :
+      nullptr;
+    return MaskFD && Kernel->getMaskFromMapping(MaskFD) == Mask;
+  };
+
+  if (Mask->isDomain()) {
+    auto OCE = dyn_cast<CXXOperatorCallExpr>(ret_val->IgnoreParenImpCasts());
+    return OCE && isMaskAccess(OCE) ? OCE : nullptr;
+  }
+
+  BinaryOperator *BO = dyn_cast<BinaryOperator>(ret_val->IgnoreParenImpCasts());
+  if (!BO || BO->getOpcode() != BO_Mul ||
+      !Ctx.hasSameUnqualifiedType(QT, BO->getType()))
+    return nullptr;
+
+  CXXOperatorCallExpr *AccCall = nullptr;
+  bool hasMask = false;
+  for (auto operand : { BO->getLHS(), BO->getRHS() }) {
+    auto OCE = dyn_cast<CXXOperatorCallExpr>(operand->IgnoreParenImpCasts());
+    if (!OCE || !isa<MemberExpr>(OCE->getArg(0)))
+      return nullptr;
+    MemberExpr *ME = dyn_cast<MemberExpr>(OCE->getArg(0));
+    FieldDecl *FD = dyn_cast<FieldDecl>(ME->getMemberDecl());
+    if (!FD)
+      return nullptr;
+
+    if (OCE->getNumArgs() == 1 && Kernel->getMaskFromMapping(FD) == Mask) {
+      hasMask = true;
+    } else if (isMaskAccess(OCE)) {
+      AccCall = OCE;
+    } else {
+      return nullptr;
+    }
+  }
+
+  return hasMask ? AccCall : nullptr;
+}
+
+
+// check if a constant Mask is separable, i.e. mask(x, y) = col[y] * row[x];
+// constant Domains defining all points are separable into ones
+bool ASTTranslate::getSeparableMask(HipaccMask *Mask, std::vector<double> &col,
+    std::vector<double> &row) {
+  size_t size_x = Mask->getSizeX(), size_y = Mask->getSizeY();
+  if (size_x < 2 || size_y < 2)
+    return false;
+
+  if (Mask->isDomain()) {
+    if (!Mask->isConstant())
+      return false;
+    for (size_t y=0; y<size_y; ++y)
+      for (size_t x=0; x<size_x; ++x)
+        if (!Mask->isDomainDefined(x, y))
+          return false;
+    col.assign(size_y, 1);
+    row.assign(size_x, 1);
+    return true;
+  }
+
+  std::vector<double> coeffs;
+  if (!getMaskCoefficients(Mask, coeffs))
+    return false;
+
+  // use the largest coefficient as pivot
+  QualType QT = Mask->getType();
+  bool isInt = QT->isIntegerType();
+  size_t px = 0, py = 0;
+  double max_coeff = 0;
+  for (size_t y=0; y<size_y; ++y) {
+    for (size_t x=0; x<size_x; ++x) {
+      if (std::abs(coeffs[y*size_x + x]) > max_coeff) {
+        max_coeff = std::abs(coeffs[y*size_x + x]);
+        px = x;
+        py = y;
+      }
+    }
+  }
+  if (max_coeff == 0)
+    return false;
+
+  // row vector: pivot row normalized to the pivot; for integer masks the
+  // pivot row divided by the gcd of its coefficients, which divides all rows
+  // of a separable integer mask
+  double norm = coeffs[py*size_x + px];
+  if (isInt) {
+    int64_t gcd = 0;
+    for (size_t x=0; x<size_x; ++x) {
+      int64_t a = static_cast<int64_t>(std::abs(coeffs[py*size_x + x]));
+      while (gcd) {
+        int64_t t = a % gcd;
+        a = gcd;
+        gcd = t;
+      }
+      gcd = a;
+    }
+    norm = static_cast<double>(gcd);
+  }
+  std::vector<double> row_coeffs(size_x), col_coeffs(size_y);
+  for (size_t x=0; x<size_x; ++x)
+    row_coeffs[x] = coeffs[py*size_x + x] / norm;
+  for (size_t y=0; y<size_y; ++y) {
+    col_coeffs[y] = coeffs[y*size_x + px] / row_coeffs[px];
+    if (isInt && col_coeffs[y] != std::round(col_coeffs[y]))
+      return false;
+  }
+
+  // verify mask(x, y) = col[y] * row[x]
+  double eps = isInt ? 0 : max_coeff * 1e-6;
+  for (size_t y=0; y<size_y; ++y) {
+    for (size_t x=0; x<size_x; ++x) {
+      if (std::abs(coeffs[y*size_x + x] - col_coeffs[y]*row_coeffs[x]) > eps)
+        return false;
+    }
+  }
+
+  col = col_coeffs;
+  row = row_coeffs;
+
+  return true;
+}
+
+
+// collect variables referenced within a statement, but declared outside
+static void getReferencedVars(Stmt *S, SmallPtrSetImpl<VarDecl *> &local,
+    SmallVectorImpl<VarDecl *> &vars) {
+  if (S == nullptr)
+    return;
+
+  if (auto DS = dyn_cast<DeclStmt>(S)) {
+    for (auto decl : DS->decls())
+      if (auto VD = dyn_cast<VarDecl>(decl))
+        local.insert(VD);
+  }
+
+  if (auto DRE = dyn_cast<DeclRefExpr>(S)) {
+    if (auto VD = dyn_cast<VarDecl>(DRE->getDecl())) {
+      bool found = local.count(VD);
+      for (auto var : vars)
+        found |= var->getName() == VD->getName();
+      if (!found)
+        vars.push_back(VD);
+    }
+  }
+
+  for (auto it = S->child_begin(); it != S->child_end(); ++it)
+    getReferencedVars(*it, local, vars);
+}
+
+
+// convolutions with separable constant masks and reductions over constant
+// Domains of the form
+//   convolve(mask, Reduce::SUM, [&] () { return mask() * Acc(mask); });
+//   reduce(dom, Reduce::SUM, [&] () { return Acc(dom); });
+// compute the row pass once per image row into a line buffer and sum up the
+// rows of the column pass, instead of unrolling size_x*size_y multiply-adds:
+// C/C++: _tmp += col[y] * KernelRow(args..., KernelEpoch, gid_x, gid_y + dy);
+// rows with uniform coefficients are computed as running sums, adding the
+// incoming and subtracting the outgoing pixel, restarted for each row;
+// columns with uniform coefficients of SUM windows are running sums of rows
+// per column, kept across the output rows of a thread:
+// C/C++: _tmp += col[0] * KernelCol(args..., KernelEpoch, gid_x, gid_y);
+// other columns and MIN/MAX reductions sum up size_y rows per pixel
+bool ASTTranslate::addSeparableConvolution(CXXMemberCallExpr *E,
+    HipaccMask *Mask, LambdaExpr *LE, CompoundStmt *outerCStmt) {
+  Reduce mode = Mask->isDomain() ? redModes.back() : convMode;
+  DeclRefExpr *tmp_var = Mask->isDomain() ? redTmps.back() : convTmp;
+  if (!compilerOptions.emitC99() || Kernel->vectorize())
+    return false;
+  // MIN/MAX reductions over rectangular Domains, e.g. dilate/erode
+  if (mode != Reduce::SUM && !(Mask->isDomain() && (mode == Reduce::MIN ||
+          mode == Reduce::MAX)))
+    return false;
+
+  CXXOperatorCallExpr *AccCall = getMaskProductAccess(LE, Mask);
+  if (!AccCall)
+    return false;
+  QualType QT = LE->getCallOperator()->getReturnType();
+  MemberExpr *AccME = dyn_cast<MemberExpr>(AccCall->getArg(0));
+  HipaccAccessor *Acc = Kernel->getImgFromMapping(
+      dyn_cast<FieldDecl>(AccME->getMemberDecl()));
+  if (Acc->getInterpolationMode() != Interpolate::NO)
+    return false;
+
+  std::vector<double> col, row;
+  if (!getSeparableMask(Mask, col, row))
+    return false;
+  bool uniform = row[0] != 0 &&
+    std::all_of(row.begin(), row.end(), [&] (double c) { return c == row[0]; });
+  bool uniform_col = mode == Reduce::SUM && col[0] != 0 &&
+    std::all_of(col.begin(), col.end(), [&] (double c) { return c == col[0]; });
+
+  // coeff * val, multiplications by one are dropped
+  QualType MQT = Mask->isDomain() ? QT : Mask->getType();
+  auto scale = [&] (double coeff, Expr *val) -> Expr * {
+    if (coeff == 1)
+      return val;
+    return createBinaryOperator(Ctx, createCoefficient(MQT, coeff), val,
+        BO_Mul, QT);
+  };
+
+  // the kernel body is cloned for each border handling variant, which share
+  // the row function, or the column function in case of running column sums
+  auto row_fun = convRowFuns.find(E);
+  if (row_fun == convRowFuns.end()) {
+    HipaccIterationSpace *IS = Kernel->getIterationSpace();
+    Expr *lower_x = createIntegerLiteral(Ctx, 0);
+    Expr *upper_x = getWidthDecl(IS);
+    if (IS->getOffsetXDecl()) {
+      lower_x = getOffsetXDecl(IS);
+      upper_x = createBinaryOperator(Ctx, upper_x, lower_x, BO_Add, Ctx.IntTy);
+    }
+
+    VarDecl *epoch_decl = createVarDecl(Ctx, kernelDecl, "_epoch",
+        Ctx.UnsignedIntTy);
+    VarDecl *gid_x_decl = createVarDecl(Ctx, kernelDecl, "gid_x", Ctx.IntTy);
+    VarDecl *gid_y_decl = createVarDecl(Ctx, kernelDecl, "gid_y", Ctx.IntTy);
+    VarDecl *x_decl = createVarDecl(Ctx, kernelDecl, "_x", Ctx.IntTy, lower_x);
+    VarDecl *sum_decl = createVarDecl(Ctx, kernelDecl, mode == Reduce::SUM ?
+        "_sum" : "_acc", QT, getInitExpr(mode, QT));
+    VarDecl *row_decl = createVarDecl(Ctx, kernelDecl, "_row",
+        Ctx.getPointerType(QT));
+    DeclRefExpr *x_ref = createDeclRefExpr(Ctx, x_decl);
+    DeclRefExpr *sum_ref = createDeclRefExpr(Ctx, sum_decl);
+    DeclRefExpr *row_ref = createDeclRefExpr(Ctx, row_decl);
+
+    // _row[idx - offset_x]
+    auto accessRow = [&] (Expr *idx) -> Expr * {
+      if (IS->getOffsetXDecl())
+        idx = createBinaryOperator(Ctx, idx, getOffsetXDecl(IS), BO_Sub,
+            Ctx.IntTy);
+      return new (Ctx) ArraySubscriptExpr(row_ref, idx, QT, VK_LValue,
+          OK_Ordinary, SourceLocation());
+    };
+
+    // read pixels at _x, gid_y with border handling at all sides, since
+    // rows are computed for the whole iteration space
+    Expr *global_id_x = tileVars.global_id_x, *global_id_y = gidYRef;
+    border_variant variant = bh_variant;
+    bool border = Acc->getBoundaryMode() != Boundary::UNDEFINED &&
+      KernelClass->getKernelType() != UserOperator;
+    tileVars.global_id_x = x_ref;
+    gidYRef = createDeclRefExpr(Ctx, gid_y_decl);
+    bh_variant.borderVal = 0;
+    if (border) {
+      bh_variant.borders.left = 1;
+      bh_variant.borders.right = 1;
+      bh_variant.borders.top = 1;
+      bh_variant.borders.bottom = 1;
+    }
+
+    // Acc(x - size_x/2, 0)
+    DeclRefExpr *LHS = dyn_cast<DeclRefExpr>(Clone(AccME));
+    auto readPixel = [&] (int x, SmallVectorImpl<Stmt *> &stmts,
+        SmallVectorImpl<CompoundStmt *> &cstmts) -> Expr * {
+      Expr *offset_x = createIntegerLiteral(Ctx, x -
+          static_cast<int>(Mask->getSizeX()/2));
+      Expr *offset_y = createIntegerLiteral(Ctx, 0);
+      return border ?
+        addBorderHandling(LHS, offset_x, offset_y, Acc, stmts, cstmts) :
+        accessMem(LHS, Acc, READ_ONLY, offset_x, offset_y);
+    };
+
+    Stmt *fill_stmt = nullptr;
+    if (mode != Reduce::SUM) {
+      // van Herk/Gil-Werman: the windows of a block of size_x outputs starting
+      // at _b are split at the last pixel of the first window into a suffix
+      // and a prefix reduction, requiring three comparisons per pixel:
+      // for (int _b = offset_x; _b < width + offset_x; _b += size_x) {
+      //   _acc = init;
+      //   for (int _x = _b + size_x - 1; _x >= _b; _x--) {
+      //     _acc = max(_acc, Acc(-size_x/2, 0));
+      //     if (_x < width + offset_x) _row[_x - offset_x] = _acc;
+      //   }
+      //   _acc = init;
+      //   for (int _x = _b + 1; _x < _b + size_x && _x < width + offset_x;
+      //        _x++) {
+      //     _acc = max(_acc, Acc(size_x - 1 - size_x/2, 0));
+      //     _row[_x - offset_x] = max(_row[_x - offset_x], _acc);
+      //   }
+      // }
+      FunctionDecl *fun = lookup<FunctionDecl>(std::string(mode==Reduce::MIN ?
+            "min" : "max"), QT, hipacc_math_ns);
+      assert(fun && "could not lookup 'min' or 'max'");
+      auto reduceVals = [&] (Expr *lhs, Expr *rhs) -> Expr * {
+        SmallVector<Expr *, 2> funArgs;
+        funArgs.push_back(lhs);
+        funArgs.push_back(rhs);
+        return createFunctionCall(Ctx, fun, funArgs);
+      };
+      Expr *size_x = createIntegerLiteral(Ctx,
+          static_cast<int>(Mask->getSizeX()));
+      VarDecl *b_decl = createVarDecl(Ctx, kernelDecl, "_b", Ctx.IntTy,
+          lower_x);
+      DeclRefExpr *b_ref = createDeclRefExpr(Ctx, b_decl);
+
+      // suffix reduction
+      VarDecl *sfx_decl = createVarDecl(Ctx, kernelDecl, "_x", Ctx.IntTy,
+          createBinaryOperator(Ctx, b_ref, createIntegerLiteral(Ctx,
+              static_cast<int>(Mask->getSizeX()) - 1), BO_Add, Ctx.IntTy));
+      DeclRefExpr *sfx_ref = createDeclRefExpr(Ctx, sfx_decl);
+      SmallVector<Stmt *, 16> sfxStmts;
+      SmallVector<CompoundStmt *, 16> sfxCStmts;
+      tileVars.global_id_x = sfx_ref;
+      sfxStmts.push_back(createBinaryOperator(Ctx, sum_ref, reduceVals(sum_ref,
+              readPixel(0, sfxStmts, sfxCStmts)), BO_Assign, QT));
+      sfxStmts.push_back(createIfStmt(Ctx, createBinaryOperator(Ctx, sfx_ref,
+              upper_x, BO_LT, Ctx.BoolTy), createBinaryOperator(Ctx,
+                accessRow(sfx_ref), sum_ref, BO_Assign, QT)));
+
+      // prefix reduction
+      VarDecl *pfx_decl = createVarDecl(Ctx, kernelDecl, "_x", Ctx.IntTy,
+          createBinaryOperator(Ctx, b_ref, createIntegerLiteral(Ctx, 1),
+            BO_Add, Ctx.IntTy));
+      DeclRefExpr *pfx_ref = createDeclRefExpr(Ctx, pfx_decl);
+      SmallVector<Stmt *, 16> pfxStmts;
+      SmallVector<CompoundStmt *, 16> pfxCStmts;
+      tileVars.global_id_x = pfx_ref;
+      pfxStmts.push_back(createBinaryOperator(Ctx, sum_ref, reduceVals(sum_ref,
+              readPixel(static_cast<int>(Mask->getSizeX()) - 1, pfxStmts,
+                pfxCStmts)), BO_Assign, QT));
+      pfxStmts.push_back(createBinaryOperator(Ctx, accessRow(pfx_ref),
+            reduceVals(accessRow(pfx_ref), sum_ref), BO_Assign, QT));
+
+      SmallVector<Stmt *, 16> blockStmts;
+      blockStmts.push_back(createBinaryOperator(Ctx, sum_ref,
+            getInitExpr(mode, QT), BO_Assign, QT));
+      blockStmts.push_back(createForStmt(Ctx, createDeclStmt(Ctx, sfx_decl),
+            createBinaryOperator(Ctx, sfx_ref, b_ref, BO_GE, Ctx.BoolTy),
+            createUnaryOperator(Ctx, sfx_ref, UO_PostDec, Ctx.IntTy),
+            createCompoundStmt(Ctx, sfxStmts)));
+      blockStmts.push_back(createBinaryOperator(Ctx, sum_ref,
+            getInitExpr(mode, QT), BO_Assign, QT));
+      blockStmts.push_back(createForStmt(Ctx, createDeclStmt(Ctx, pfx_decl),
+            createBinaryOperator(Ctx, createBinaryOperator(Ctx, pfx_ref,
+                createBinaryOperator(Ctx, b_ref, size_x, BO_Add, Ctx.IntTy),
+                BO_LT, Ctx.BoolTy), createBinaryOperator(Ctx, pfx_ref, upper_x,
+                  BO_LT, Ctx.BoolTy), BO_LAnd, Ctx.BoolTy),
+            createUnaryOperator(Ctx, pfx_ref, UO_PostInc, Ctx.IntTy),
+            createCompoundStmt(Ctx, pfxStmts)));
+
+      fill_stmt = createForStmt(Ctx, createDeclStmt(Ctx, b_decl),
+          createBinaryOperator(Ctx, b_ref, upper_x, BO_LT, Ctx.BoolTy),
+          createCompoundAssignOperator(Ctx, b_ref, size_x, BO_AddAssign,
+            Ctx.IntTy), createCompoundStmt(Ctx, blockStmts));
+    } else {
+      // T _sum = 0;
+      // _sum += row[x] * Acc(x - size_x/2, 0); ...
+      // _row[_x - offset_x] = _sum;
+      SmallVector<Stmt *, 16> sumStmts;
+      SmallVector<CompoundStmt *, 16> sumCStmts;
+      if (!uniform)
+        sumStmts.push_back(createDeclStmt(Ctx, sum_decl));
+      for (size_t x=0; x<row.size(); ++x) {
+        if (row[x] == 0)
+          continue;
+        sumStmts.push_back(createCompoundAssignOperator(Ctx, sum_ref,
+              scale(uniform ? 1 : row[x], readPixel(x, sumStmts, sumCStmts)),
+              BO_AddAssign, QT));
+      }
+
+      Stmt *loop_body = nullptr;
+      if (uniform) {
+        // if (_x == lower_x) {
+        //   _sum = 0; _sum += Acc(x - size_x/2, 0); ...
+        // } else {
+        //   _sum += Acc(size_x - 1 - size_x/2, 0) - Acc(-1 - size_x/2, 0);
+        // }
+        // _row[_x - offset_x] = row[0] * _sum;
+        SmallVector<Stmt *, 16> slideStmts;
+        SmallVector<CompoundStmt *, 16> slideCStmts;
+        Expr *in = readPixel(static_cast<int>(row.size()) - 1, slideStmts,
+            slideCStmts);
+        Expr *out = readPixel(-1, slideStmts, slideCStmts);
+        slideStmts.push_back(createCompoundAssignOperator(Ctx, sum_ref,
+              createBinaryOperator(Ctx, in, out, BO_Sub, QT), BO_AddAssign,
+              QT));
+        sumStmts.insert(sumStmts.begin(), createBinaryOperator(Ctx, sum_ref,
+              getInitExpr(Reduce::SUM, QT), BO_Assign, QT));
+
+        SmallVector<Stmt *, 16> bodyStmts;
+        bodyStmts.push_back(createIfStmt(Ctx, createBinaryOperator(Ctx, x_ref,
+                lower_x, BO_EQ, Ctx.BoolTy), createCompoundStmt(Ctx, sumStmts),
+              createCompoundStmt(Ctx, slideStmts)));
+        bodyStmts.push_back(createBinaryOperator(Ctx, accessRow(x_ref),
+              scale(row[0], sum_ref), BO_Assign, QT));
+        loop_body = createCompoundStmt(Ctx, bodyStmts);
+      } else {
+        sumStmts.push_back(createBinaryOperator(Ctx, accessRow(x_ref), sum_ref,
+              BO_Assign, QT));
+        loop_body = createCompoundStmt(Ctx, sumStmts);
+      }
+
+      // for (int _x = offset_x; _x < width + offset_x; _x++) { ... }
+      fill_stmt = createForStmt(Ctx, createDeclStmt(Ctx, x_decl),
+          createBinaryOperator(Ctx, x_ref, upper_x, BO_LT, Ctx.BoolTy),
+          createUnaryOperator(Ctx, x_ref, UO_PostInc, Ctx.IntTy), loop_body);
+    }
+
+    tileVars.global_id_x = global_id_x;
+    gidYRef = global_id_y;
+    bh_variant = variant;
+
+    // static thread_local HipaccLineBuffer<T> _buffer;
+    RecordDecl *buffer_class = createRecordDecl(Ctx,
+        Ctx.getTranslationUnitDecl(), "HipaccLineBuffer", TTK_Class,
+        ArrayRef<QualType>(), ArrayRef<StringRef>());
+    TypedefDecl *buffer_type = TypedefDecl::Create(Ctx,
+        Ctx.getTranslationUnitDecl(), SourceLocation(), SourceLocation(),
+        &Ctx.Idents.get("HipaccLineBuffer<" + QT.getAsString() + ">"),
+        Ctx.getTrivialTypeSourceInfo(Ctx.getRecordType(buffer_class)));
+    VarDecl *buffer_decl = createVarDecl(Ctx, kernelDecl, "_buffer",
+        Ctx.getTypeDeclType(buffer_type));
+    buffer_decl->setStorageClass(SC_Static);
+    buffer_decl->setTSCSpec(TSCS_thread_local);
+    VarDecl *fill_decl = createVarDecl(Ctx, kernelDecl, "_fill", Ctx.BoolTy);
+    DeclRefExpr *fill_ref = createDeclRefExpr(Ctx, fill_decl);
+
+    // T *_row = hipaccGetLineBufferRow(_buffer, gid_y, width, size_y, _epoch,
+    //                                  _fill);
+    SmallVector<QualType, 16> getRowTypes;
+    SmallVector<std::string, 16> getRowNames;
+    SmallVector<Expr *, 16> getRowArgs;
+    getRowTypes.push_back(buffer_decl->getType());
+    getRowNames.push_back("buffer");
+    getRowArgs.push_back(createDeclRefExpr(Ctx, buffer_decl));
+    getRowTypes.push_back(Ctx.IntTy);
+    getRowNames.push_back("y");
+    getRowArgs.push_back(createDeclRefExpr(Ctx, gid_y_decl));
+    getRowTypes.push_back(Ctx.IntTy);
+    getRowNames.push_back("width");
+    getRowArgs.push_back(getWidthDecl(IS));
+    getRowTypes.push_back(Ctx.IntTy);
+    getRowNames.push_back("rows");
+    // running column sums subtract the row preceding the window
+    getRowArgs.push_back(createIntegerLiteral(Ctx,
+          static_cast<int>(Mask->getSizeY()) + (uniform_col ? 1 : 0)));
+    getRowTypes.push_back(Ctx.UnsignedIntTy);
+    getRowNames.push_back("epoch");
+    getRowArgs.push_back(createDeclRefExpr(Ctx, epoch_decl));
+    getRowTypes.push_back(Ctx.BoolTy);
+    getRowNames.push_back("fill");
+    getRowArgs.push_back(fill_ref);
+    FunctionDecl *get_row = createFunctionDecl(Ctx,
+        Ctx.getTranslationUnitDecl(), "hipaccGetLineBufferRow",
+        row_decl->getType(), getRowTypes, getRowNames);
+    row_decl->setInit(createFunctionCall(Ctx, get_row, getRowArgs));
+
+    // if (_fill) { ... }
+    // return _row[gid_x - offset_x];
+    SmallVector<Stmt *, 16> funBody;
+    funBody.push_back(createDeclStmt(Ctx, buffer_decl));
+    funBody.push_back(createDeclStmt(Ctx, fill_decl));
+    funBody.push_back(createDeclStmt(Ctx, row_decl));
+    if (uniform)
+      funBody.push_back(createDeclStmt(Ctx, sum_decl));
+    funBody.push_back(createIfStmt(Ctx, fill_ref, fill_stmt));
+    funBody.push_back(createReturnStmt(Ctx,
+          accessRow(createDeclRefExpr(Ctx, gid_x_decl))));
+    CompoundStmt *fun_body = createCompoundStmt(Ctx, funBody);
+
+    // arguments: kernel variables referenced by the row pass
+    SmallPtrSet<VarDecl *, 16> local;
+    SmallVector<VarDecl *, 16> args;
+    local.insert(epoch_decl);
+    local.insert(gid_x_decl);
+    local.insert(gid_y_decl);
+    getReferencedVars(fun_body, local, args);
+
+    SmallVector<QualType, 16> argTypes;
+    SmallVector<std::string, 16> argNames;
+    for (auto arg : args) {
+      // images are only read by the row pass
+      QualType argQT = arg->getType();
+      if (argQT->isPointerType())
+        argQT = Ctx.getPointerType(Ctx.getConstType(argQT->getPointeeType()));
+      argTypes.push_back(argQT);
+      argNames.push_back(arg->getNameAsString());
+    }
+    argTypes.push_back(Ctx.UnsignedIntTy);
+    argNames.push_back("_epoch");
+    argTypes.push_back(Ctx.IntTy);
+    argNames.push_back("gid_x");
+    argTypes.push_back(Ctx.IntTy);
+    argNames.push_back("gid_y");
+
+    FunctionDecl *fun = createFunctionDecl(Ctx, Ctx.getTranslationUnitDecl(),
+        Kernel->getKernelName() + "Row" + std::to_string(literalCount++), QT,
+        argTypes, argNames);
+    fun->setBody(fun_body);
+    Kernel->addFunctionCall(fun);
+    Kernel->setLineBuffered();
+
+    if (uniform_col) {
+      // KernelRow(args..., _epoch, gid_x, gid_y + dy)
+      auto callRow = [&] (int dy) -> Expr * {
+        SmallVector<Expr *, 16> rowArgs;
+        for (auto arg : args)
+          rowArgs.push_back(createDeclRefExpr(Ctx, arg));
+        rowArgs.push_back(createDeclRefExpr(Ctx, epoch_decl));
+        rowArgs.push_back(createDeclRefExpr(Ctx, gid_x_decl));
+        Expr *y = createDeclRefExpr(Ctx, gid_y_decl);
+        if (dy)
+          y = createBinaryOperator(Ctx, y, createIntegerLiteral(Ctx, dy),
+              BO_Add, Ctx.IntTy);
+        rowArgs.push_back(y);
+        return createFunctionCall(Ctx, fun, rowArgs);
+      };
+
+      // static thread_local HipaccColumnSums<T> _sums;
+      RecordDecl *sums_class = createRecordDecl(Ctx,
+          Ctx.getTranslationUnitDecl(), "HipaccColumnSums", TTK_Class,
+          ArrayRef<QualType>(), ArrayRef<StringRef>());
+      TypedefDecl *sums_type = TypedefDecl::Create(Ctx,
+          Ctx.getTranslationUnitDecl(), SourceLocation(), SourceLocation(),
+          &Ctx.Idents.get("HipaccColumnSums<" + QT.getAsString() + ">"),
+          Ctx.getTrivialTypeSourceInfo(Ctx.getRecordType(sums_class)));
+      VarDecl *sums_decl = createVarDecl(Ctx, kernelDecl, "_sums",
+          Ctx.getTypeDeclType(sums_type));
+      sums_decl->setStorageClass(SC_Static);
+      sums_decl->setTSCSpec(TSCS_thread_local);
+      VarDecl *tags_decl = createVarDecl(Ctx, kernelDecl, "_tags",
+          Ctx.getPointerType(Ctx.IntTy));
+
+      // T *_col = hipaccGetColumnSums(_sums, width, _epoch, _tags);
+      SmallVector<QualType, 16> getSumsTypes;
+      SmallVector<std::string, 16> getSumsNames;
+      SmallVector<Expr *, 16> getSumsArgs;
+      getSumsTypes.push_back(sums_decl->getType());
+      getSumsNames.push_back("sums");
+      getSumsArgs.push_back(createDeclRefExpr(Ctx, sums_decl));
+      getSumsTypes.push_back(Ctx.IntTy);
+      getSumsNames.push_back("width");
+      getSumsArgs.push_back(getWidthDecl(IS));
+      getSumsTypes.push_back(Ctx.UnsignedIntTy);
+      getSumsNames.push_back("epoch");
+      getSumsArgs.push_back(createDeclRefExpr(Ctx, epoch_decl));
+      getSumsTypes.push_back(Ctx.getLValueReferenceType(tags_decl->getType()));
+      getSumsNames.push_back("tags");
+      getSumsArgs.push_back(createDeclRefExpr(Ctx, tags_decl));
+      VarDecl *col_decl = createVarDecl(Ctx, kernelDecl, "_col",
+          Ctx.getPointerType(QT), createFunctionCall(Ctx, createFunctionDecl(
+              Ctx, Ctx.getTranslationUnitDecl(), "hipaccGetColumnSums",
+              Ctx.getPointerType(QT), getSumsTypes, getSumsNames),
+            getSumsArgs));
+
+      // _col[gid_x - offset_x], _tags[gid_x - offset_x]
+      auto accessCol = [&] (VarDecl *VD, QualType T) -> Expr * {
+        Expr *idx = createDeclRefExpr(Ctx, gid_x_decl);
+        if (IS->getOffsetXDecl())
+          idx = createBinaryOperator(Ctx, idx, getOffsetXDecl(IS), BO_Sub,
+              Ctx.IntTy);
+        return new (Ctx) ArraySubscriptExpr(createDeclRefExpr(Ctx, VD), idx,
+            T, VK_LValue, OK_Ordinary, SourceLocation());
+      };
+
+      // if (_tags[gid_x - offset_x] == gid_y - 1) {
+      //   _col[gid_x - offset_x] += KernelRow(..., gid_y + size_y/2) -
+      //                             KernelRow(..., gid_y - size_y/2 - 1);
+      // } else if (_tags[gid_x - offset_x] != gid_y) {
+      //   _col[gid_x - offset_x] = KernelRow(..., gid_y - size_y/2) + ...;
+      // }
+      // _tags[gid_x - offset_x] = gid_y;
+      // return _col[gid_x - offset_x];
+      int half = static_cast<int>(Mask->getSizeY()/2);
+      Stmt *slide = createCompoundAssignOperator(Ctx, accessCol(col_decl, QT),
+          createBinaryOperator(Ctx, callRow(static_cast<int>(col.size()) - 1 -
+              half), callRow(-half - 1), BO_Sub, QT), BO_AddAssign, QT);
+      Expr *full = nullptr;
+      for (size_t y=0; y<col.size(); ++y) {
+        Expr *val = callRow(static_cast<int>(y) - half);
+        full = full ? createBinaryOperator(Ctx, full, val, BO_Add, QT) : val;
+      }
+      Stmt *fill = createBinaryOperator(Ctx, accessCol(col_decl, QT), full,
+          BO_Assign, QT);
+
+      SmallVector<Stmt *, 16> colBody;
+      colBody.push_back(createDeclStmt(Ctx, sums_decl));
+      colBody.push_back(createDeclStmt(Ctx, tags_decl));
+      colBody.push_back(createDeclStmt(Ctx, col_decl));
+      colBody.push_back(createIfStmt(Ctx, createBinaryOperator(Ctx,
+              accessCol(tags_decl, Ctx.IntTy), createBinaryOperator(Ctx,
+                createDeclRefExpr(Ctx, gid_y_decl), createIntegerLiteral(Ctx,
+                  1), BO_Sub, Ctx.IntTy), BO_EQ, Ctx.BoolTy),
+            createCompoundStmt(Ctx, slide), createIfStmt(Ctx,
+              createBinaryOperator(Ctx, accessCol(tags_decl, Ctx.IntTy),
+                createDeclRefExpr(Ctx, gid_y_decl), BO_NE, Ctx.BoolTy),
+              createCompoundStmt(Ctx, fill))));
+      colBody.push_back(createBinaryOperator(Ctx, accessCol(tags_decl,
+              Ctx.IntTy), createDeclRefExpr(Ctx, gid_y_decl), BO_Assign,
+            Ctx.IntTy));
+      colBody.push_back(createReturnStmt(Ctx, accessCol(col_decl, QT)));
+
+      // same arguments as the row function
+      fun = createFunctionDecl(Ctx, Ctx.getTranslationUnitDecl(),
+          Kernel->getKernelName() + "Col" + std::to_string(literalCount++), QT,
+          argTypes, argNames);
+      fun->setBody(createCompoundStmt(Ctx, colBody));
+      Kernel->addFunctionCall(fun);
+    }
+
+    row_fun = convRowFuns.emplace(E, std::make_pair(fun, args)).first;
+  }
+
+  // column pass: _tmp += col[y] * KernelRow(args..., KernelEpoch, gid_x,
+  //                                         gid_y + y - size_y/2);
+  // running column sums: _tmp += col[0] * KernelCol(args..., KernelEpoch,
+  //                                                 gid_x, gid_y);
+  VarDecl *epoch = createVarDecl(Ctx, kernelDecl, Kernel->getEpochName(),
+      Ctx.UnsignedIntTy);
+  for (size_t y=0; y<col.size(); ++y) {
+    if (col[y] == 0 || (uniform_col && y))
+      continue;
+
+    SmallVector<Expr *, 16> args;
+    for (auto arg : row_fun->second.second)
+      args.push_back(createDeclRefExpr(Ctx, arg));
+    args.push_back(createDeclRefExpr(Ctx, epoch));
+    args.push_back(tileVars.global_id_x);
+    int offset_y = uniform_col ? 0 :
+      static_cast<int>(y) - static_cast<int>(Mask->getSizeY()/2);
+    if (offset_y)
+      args.push_back(createBinaryOperator(Ctx, gidYRef,
+            createIntegerLiteral(Ctx, offset_y), BO_Add, Ctx.IntTy));
+    else
+      args.push_back(gidYRef);
+
+    preStmts.push_back(getConvolutionStmt(mode, tmp_var, scale(col[y],
+            createFunctionCall(Ctx, row_fun->second.first, args))));
+    preCStmt.push_back(outerCStmt);
+  }
+
+  return true;
+}
+
+
+// convolutions with constant masks of the form
+//   convolve(mask, Reduce::SUM, [&] () { return mask() * Acc(mask); });
+// skip zero coefficients and sum up pixels with equal coefficients before
+// multiplying; multiplications by +-1 are dropped:
+//   _tmp += c * (Acc(x0, y0) + Acc(x1, y1) + ...);
+bool ASTTranslate::addFactoredConvolution(HipaccMask *Mask, LambdaExpr *LE,
+    CompoundStmt *outerCStmt) {
+  if (convMode != Reduce::SUM ||
+      (Kernel->vectorize() && !compilerOptions.emitC99()))
+    return false;
+
+  std::vector<double> coeffs;
+  CXXOperatorCallExpr *AccCall = getMaskProductAccess(LE, Mask);
+  if (!AccCall || !getMaskCoefficients(Mask, coeffs))
+    return false;
+
+  QualType QT = LE->getCallOperator()->getReturnType();
+
+  // group taps by coefficient in order of appearance
+  SmallVector<double, 16> groupCoeffs;
+  SmallVector<SmallVector<std::pair<int, int>, 16>, 16> groupTaps;
+  for (size_t y=0; y<Mask->getSizeY(); ++y) {
+    for (size_t x=0; x<Mask->getSizeX(); ++x) {
+      double coeff = coeffs[y*Mask->getSizeX() + x];
+      if (coeff == 0)
+        continue;
+
+      size_t i = 0;
+      while (i < groupCoeffs.size() && groupCoeffs[i] != coeff)
+        ++i;
+      if (i == groupCoeffs.size()) {
+        groupCoeffs.push_back(coeff);
+        groupTaps.emplace_back();
+      }
+      groupTaps[i].push_back(std::make_pair(static_cast<int>(x),
+            static_cast<int>(y)));
+    }
+  }
+
+  for (size_t i=0; i<groupCoeffs.size(); ++i) {
+    // Acc(x0, y0) + Acc(x1, y1) + ...
+    Expr *sum = nullptr;
+    for (auto tap : groupTaps[i]) {
+      convIdxX = tap.first;
+      convIdxY = tap.second;
+      Expr *pixel = Clone(AccCall);
+      sum = sum ? createBinaryOperator(Ctx, sum, pixel, BO_Add, QT) : pixel;
+    }
+    if (groupTaps[i].size() > 1)
+      sum = createParenExpr(Ctx, sum);
+
+    // the C/C++ compiler strength-reduces multiplications by powers of two;
+    // shifting here would be undefined for negative signed sums
+    double coeff = groupCoeffs[i];
+    Expr *val = nullptr;
+    if (std::abs(coeff) == 1) {
+      val = sum;
+      if (coeff < 0)
+        val = createUnaryOperator(Ctx, val, UO_Minus, QT);
+    } else {
+      val = createBinaryOperator(Ctx, createCoefficient(Mask->getType(),
+            coeff), sum, BO_Mul, QT);
+    }
+
+    preStmts.push_back(getConvolutionStmt(convMode, convTmp, val));
+    preCStmt.push_back(outerCStmt);
+  }
+
+  return true;
+}
+
+
+// comparator of a median selection network: moves the minimum of two values to
+// index i and the maximum to index j; only the outputs contributing to the
+// median are computed
+struct MedianComparator {
+  unsigned i, j;
+  bool min, max;
+};
+
+// create selection network for the median of num values
+static void getMedianNetwork(unsigned num,
+    SmallVectorImpl<MedianComparator> &network) {
+  SmallVector<std::pair<unsigned, unsigned>, 128> comparators;
+
+  if (num == 9) {
+    // optimal network for 3x3 windows
+    static const unsigned med9[19][2] = {
+      {1, 2}, {4, 5}, {7, 8}, {0, 1}, {3, 4}, {6, 7}, {1, 2}, {4, 5}, {7, 8},
+      {0, 3}, {5, 8}, {4, 7}, {3, 6}, {1, 4}, {2, 5}, {4, 7}, {4, 2}, {6, 4},
+      {4, 2} };
+    for (auto &c : med9)
+      comparators.push_back(std::make_pair(c[0], c[1]));
+  } else {
+    // Batcher's odd-even merge sort
+    for (unsigned p=1; p<num; p<<=1) {
+      for (unsigned k=p; k>=1; k>>=1) {
+        for (unsigned j=k%p; j+k<num; j+=2*k) {
+          for (unsigned i=0; i<std::min(k, num-j-k); ++i) {
+            if ((i+j)/(2*p) == (i+j+k)/(2*p))
+              comparators.push_back(std::make_pair(i+j, i+j+k));
+          }
+        }
+      }
+    }
+  }
+
+  // prune comparators not contributing to the median, starting at the end
+  std::vector<bool> needed(num, false);
+  needed[num/2] = true;
+  for (auto it=comparators.rbegin(), ie=comparators.rend(); it!=ie; ++it) {
+    bool min = needed[it->first], max = needed[it->second];
+    if (!min && !max) continue;
+    network.push_back({ it->first, it->second, min, max });
+    needed[it->first] = needed[it->second] = true;
+  }
+  std::reverse(network.begin(), network.end());
+}
+
+
+// check if the values of a median window depend only on the position within
+// the window, so that the window can slide along a row: the lambda-function
+// reads Accessors without interpolation at the iteration point and uses
+// otherwise only literals, scalar kernel members, and its own variables
+static bool isSlidingWindow(Stmt *S, FieldDecl *FD, HipaccKernel *Kernel,
+    SmallPtrSetImpl<const VarDecl *> &locals) {
+  if (!S) return true;
+
+  if (auto DS = dyn_cast<DeclStmt>(S)) {
+    for (auto decl : DS->decls())
+      if (auto VD = dyn_cast<VarDecl>(decl))
+        locals.insert(VD);
+  }
+
+  // Accessor(Mask/Domain)
+  if (auto OCE = dyn_cast<CXXOperatorCallExpr>(S)) {
+    auto ME = dyn_cast<MemberExpr>(OCE->getArg(0)->IgnoreImpCasts());
+    auto AFD = ME ? dyn_cast<FieldDecl>(ME->getMemberDecl()) : nullptr;
+    HipaccAccessor *Acc = AFD ? Kernel->getImgFromMapping(AFD) : nullptr;
+    if (!Acc || OCE->getNumArgs() != 2 ||
+        Acc->getInterpolationMode() != Interpolate::NO)
+      return false;
+    auto MME = dyn_cast<MemberExpr>(OCE->getArg(1)->IgnoreImpCasts());
+    return MME && MME->getMemberDecl() == FD;
+  }
+
+  if (auto ME = dyn_cast<MemberExpr>(S))
+    return isa<FieldDecl>(ME->getMemberDecl()) &&
+           isa<CXXThisExpr>(ME->getBase()->IgnoreImpCasts()) &&
+           ME->getType()->isArithmeticType();
+
+  if (auto DRE = dyn_cast<DeclRefExpr>(S)) {
+    if (auto VD = dyn_cast<VarDecl>(DRE->getDecl()))
+      return locals.count(VD);
+    return true;
+  }
+
+  if (isa<CXXMemberCallExpr>(S))
+    return false;
+
+  for (auto child : S->children())
+    if (!isSlidingWindow(child, FD, Kernel, locals))
+      return false;
+
+  return true;
+}
+
+
+// declare storage for the values of median convolutions/reductions: values are
+// stored in an array and selected by a sorting network; for 8-bit values and
+// large windows on the CPU, values are counted in a histogram instead, which
+// slides along the rows if the window values are position-independent. FPGA
+// targets store the values in scalar variables, so that the network maps to
+// registers and comparators pipelined with the pixel loop rather than to a
+// memory with two ports
+void ASTTranslate::addMedianValues(HipaccMask *Mask, FieldDecl *FD,
+    LambdaExpr *LE, DeclRefExpr *tmp_var, CompoundStmt *outerCStmt) {
+  if (Mask->isDomain() && !Mask->isConstant()) {
+    unsigned DiagIDMedian = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "Reduce::MEDIAN requires a Domain with constant iteration space.");
+    Diags.Report(LE->getLocStart(), DiagIDMedian);
+    exit(EXIT_FAILURE);
+  }
+  if (containsBreak.back()) {
+    unsigned DiagIDMedian = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+        "break_iterate() is not supported in combination with Reduce::MEDIAN.");
+    Diags.Report(LE->getLocStart(), DiagIDMedian);
+    exit(EXIT_FAILURE);
+  }
+
+  unsigned num = 0;
+  for (size_t y=0; y<Mask->getSizeY(); ++y) {
+    for (size_t x=0; x<Mask->getSizeX(); ++x) {
+      if (!Mask->isDomain() || Mask->isDomainDefined(x, y)) ++num;
+    }
+  }
+
+  // the pruned selection network grows with O(n log^2 n) comparators, e.g.
+  // 113 for 5x5 and 208 for 7x5 windows, while the sliding histogram costs
+  // about the same for all window sizes: on a 2048x2048 8-bit image, scalar
+  // code of the network is on par with the histogram for 5x5 windows and 2-4x
+  // slower for 7x5 windows. Vectorized kernels compute the network for
+  // several pixels at once and keep it for windows of up to 11x11 values.
+  QualType QT = tmp_var->getType();
+  bool histogram = compilerOptions.emitC99() &&
+    num > (Kernel->vectorize() ? 121u : 25u) &&
+    (QT->isSpecificBuiltinType(BuiltinType::UChar) ||
+     QT->isSpecificBuiltinType(BuiltinType::Char_U));
+  // vectorized loops process pixels out of order
+  SmallPtrSet<const VarDecl *, 16> locals;
+  bool sliding = histogram && !Kernel->vectorize() &&
+    num == Mask->getSizeX() * Mask->getSizeY() &&
+    isSlidingWindow(LE->getBody(), FD, Kernel, locals);
+
+  std::string lit(std::to_string(literalCount++));
+  VarDecl *values_decl = nullptr;
+  if (sliding) {
+    // static thread_local HipaccMedianHistogram<T> _hist;
+    RecordDecl *hist_class = createRecordDecl(Ctx,
+        Ctx.getTranslationUnitDecl(), "HipaccMedianHistogram", TTK_Class,
+        ArrayRef<QualType>(), ArrayRef<StringRef>());
+    TypedefDecl *hist_type = TypedefDecl::Create(Ctx,
+        Ctx.getTranslationUnitDecl(), SourceLocation(), SourceLocation(),
+        &Ctx.Idents.get("HipaccMedianHistogram<" + QT.getAsString() + ">"),
+        Ctx.getTrivialTypeSourceInfo(Ctx.getRecordType(hist_class)));
+    values_decl = createVarDecl(Ctx, kernelDecl, "_hist" + lit,
+        Ctx.getTypeDeclType(hist_type));
+    values_decl->setStorageClass(SC_Static);
+    values_decl->setTSCSpec(TSCS_thread_local);
+    // the histogram is rebuilt per kernel execution
+    Kernel->setLineBuffered();
+  } else if (histogram) {
+    // unsigned int _hist[256] = { 0 };
+    QualType AT = Ctx.getConstantArrayType(Ctx.UnsignedIntTy,
+        llvm::APInt(32, 256), ArrayType::Normal, 0);
+    SmallVector<Expr *, 1> initExprs;
+    initExprs.push_back(createIntegerLiteral(Ctx, 0u));
+    InitListExpr *init = new (Ctx) InitListExpr(Ctx, SourceLocation(),
+        initExprs, SourceLocation());
+    init->setType(AT);
+    values_decl = createVarDecl(Ctx, kernelDecl, "_hist" + lit, AT, init);
+  } else if (compilerOptions.emitVivado() ||
+             compilerOptions.emitOpenCLFPGA()) {
+    // T _med_0, ..., _med_num-1;
+    DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
+    MedianValues median(nullptr, false, false);
+    for (unsigned i=0; i<num; ++i) {
+      VarDecl *reg_decl = createVarDecl(Ctx, kernelDecl, "_med" + lit + "_" +
+          std::to_string(i), QT);
+      DC->addDecl(reg_decl);
+      preStmts.push_back(createDeclStmt(Ctx, reg_decl));
+      preCStmt.push_back(outerCStmt);
+      median.registers.push_back(createDeclRefExpr(Ctx, reg_decl));
+    }
+    medianValues[tmp_var] = median;
+    return;
+  } else {
+    // T _med[num];
+    QualType AT = Ctx.getConstantArrayType(QT, llvm::APInt(32, num),
+        ArrayType::Normal, 0);
+    values_decl = createVarDecl(Ctx, kernelDecl, "_med" + lit, AT);
+  }
+  DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
+  DC->addDecl(values_decl);
+  preStmts.push_back(createDeclStmt(Ctx, values_decl));
+  preCStmt.push_back(outerCStmt);
+
+  medianValues[tmp_var] = MedianValues(createDeclRefExpr(Ctx, values_decl),
+      histogram, sliding);
+}
+
+
+// access the value of a median convolution/reduction at the given index
+Expr *ASTTranslate::accessMedianValue(MedianValues &median, unsigned idx) {
+  if (!median.registers.empty()) {
+    assert(idx < median.registers.size() && "median value out of bounds");
+    return median.registers[idx];
+  }
+
+  return accessArray(Ctx, median.values, createIntegerLiteral(Ctx,
+        static_cast<int32_t>(idx)));
+}
+
+
+// slide the histogram to the current pixel and add the values of the column
+// entering the window, otherwise add all values column by column:
+// if (hipaccSlideHistogram(_hist, gid_x, gid_y, size_x, size_y, KernelEpoch))
+//   { add column size_x-1 } else { add columns 0 .. size_x-1 }
+Stmt *ASTTranslate::addMedianSlidingWindow(HipaccMask *Mask, DeclRefExpr
+    *tmp_var, const std::function<Stmt *(int, int, Expr *, Expr *)>
+    &cloneIteration) {
+  MedianValues &median = medianValues[tmp_var];
+  int size_x = static_cast<int>(Mask->getSizeX());
+  int size_y = static_cast<int>(Mask->getSizeY());
+
+  SmallVector<Stmt *, 16> column, window;
+  for (int x=0; x<size_x; ++x) {
+    for (int y=0; y<size_y; ++y) {
+      window.push_back(cloneIteration(x, y, nullptr, nullptr));
+      median.index++;
+    }
+  }
+  for (int y=0; y<size_y; ++y)
+    column.push_back(cloneIteration(size_x-1, y, nullptr, nullptr));
+
+  SmallVector<QualType, 6> argTypes;
+  SmallVector<std::string, 6> argNames;
+  SmallVector<Expr *, 6> args;
+  argTypes.push_back(median.values->getType());
+  argNames.push_back("hist");
+  args.push_back(median.values);
+  argTypes.push_back(Ctx.IntTy);
+  argNames.push_back("x");
+  args.push_back(tileVars.global_id_x);
+  argTypes.push_back(Ctx.IntTy);
+  argNames.push_back("y");
+  args.push_back(gidYRef);
+  argTypes.push_back(Ctx.IntTy);
+  argNames.push_back("size_x");
+  args.push_back(createIntegerLiteral(Ctx, size_x));
+  argTypes.push_back(Ctx.IntTy);
+  argNames.push_back("size_y");
+  args.push_back(createIntegerLiteral(Ctx, size_y));
+  argTypes.push_back(Ctx.UnsignedIntTy);
+  argNames.push_back("epoch");
+  args.push_back(createDeclRefExpr(Ctx, createVarDecl(Ctx, kernelDecl,
+          Kernel->getEpochName(), Ctx.UnsignedIntTy)));
+  FunctionDecl *slide = createFunctionDecl(Ctx, Ctx.getTranslationUnitDecl(),
+      "hipaccSlideHistogram", Ctx.BoolTy, argTypes, argNames);
+
+  return createIfStmt(Ctx, createFunctionCall(Ctx, slide, args),
+      createCompoundStmt(Ctx, column), createCompoundStmt(Ctx, window));
+}
+
+
+// select the median of the values stored by all iterations; for an even number
+// of values, the upper median is selected
+void ASTTranslate::addMedianSelection(DeclRefExpr *tmp_var, CompoundStmt
+    *outerCStmt) {
+  MedianValues median = medianValues[tmp_var];
+  medianValues.erase(tmp_var);
+  QualType QT = tmp_var->getType();
+  DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
+  unsigned num = median.index;
+
+  if (median.sliding) {
+    // _tmp = hipaccGetHistogramMedian(_hist);
+    SmallVector<QualType, 1> argTypes;
+    SmallVector<std::string, 1> argNames;
+    SmallVector<Expr *, 1> args;
+    argTypes.push_back(median.values->getType());
+    argNames.push_back("hist");
+    args.push_back(median.values);
+    FunctionDecl *get = createFunctionDecl(Ctx, Ctx.getTranslationUnitDecl(),
+        "hipaccGetHistogramMedian", QT, argTypes, argNames);
+    preStmts.push_back(createBinaryOperator(Ctx, tmp_var,
+          createFunctionCall(Ctx, get, args), BO_Assign, QT));
+    preCStmt.push_back(outerCStmt);
+    return;
+  }
+
+  if (median.histogram) {
+    // int _bin = 0;
+    // unsigned int _cnt = _hist[0];
+    // while (_cnt <= num/2) { ++_bin; _cnt += _hist[_bin]; }
+    // _tmp = _bin;
+    std::string lit(std::to_string(literalCount++));
+    VarDecl *bin_decl = createVarDecl(Ctx, kernelDecl, "_bin" + lit,
+        Ctx.IntTy, createIntegerLiteral(Ctx, 0));
+    VarDecl *cnt_decl = createVarDecl(Ctx, kernelDecl, "_cnt" + lit,
+        Ctx.UnsignedIntTy, accessArray(Ctx, median.values,
+          createIntegerLiteral(Ctx, 0)));
+    DC->addDecl(bin_decl);
+    DC->addDecl(cnt_decl);
+    DeclRefExpr *bin = createDeclRefExpr(Ctx, bin_decl);
+    DeclRefExpr *cnt = createDeclRefExpr(Ctx, cnt_decl);
+
+    SmallVector<Stmt *, 2> body;
+    body.push_back(createUnaryOperator(Ctx, bin, UO_PreInc, Ctx.IntTy));
+    body.push_back(createCompoundAssignOperator(Ctx, cnt, accessArray(Ctx,
+            median.values, bin), BO_AddAssign, Ctx.UnsignedIntTy));
+
+    preStmts.push_back(createDeclStmt(Ctx, bin_decl));
+    preCStmt.push_back(outerCStmt);
+    preStmts.push_back(createDeclStmt(Ctx, cnt_decl));
+    preCStmt.push_back(outerCStmt);
+    preStmts.push_back(createWhileStmt(Ctx, nullptr, createBinaryOperator(Ctx,
+            cnt, createIntegerLiteral(Ctx, num/2), BO_LE, Ctx.BoolTy),
+          createCompoundStmt(Ctx, body)));
+    preCStmt.push_back(outerCStmt);
+    preStmts.push_back(createBinaryOperator(Ctx, tmp_var,
+          createCStyleCastExpr(Ctx, QT, CK_IntegralCast, bin, nullptr,
+            Ctx.getTrivialTypeSourceInfo(QT)), BO_Assign, QT));
+    preCStmt.push_back(outerCStmt);
+    return;
+  }
+
+  FunctionDecl *min_fun = lookup<FunctionDecl>(std::string("min"), QT,
+      hipacc_math_ns);
+  FunctionDecl *max_fun = lookup<FunctionDecl>(std::string("max"), QT,
+      hipacc_math_ns);
+  assert(min_fun && "could not lookup 'min'");
+  assert(max_fun && "could not lookup 'max'");
+
+  auto createMinMax = [&] (FunctionDecl *fun, unsigned i, unsigned j) {
+    SmallVector<Expr *, 2> funArgs;
+    funArgs.push_back(accessMedianValue(median, i));
+    funArgs.push_back(accessMedianValue(median, j));
+    return createFunctionCall(Ctx, fun, funArgs);
+  };
+  auto accessValue = [&] (unsigned idx) {
+    return accessMedianValue(median, idx);
+  };
+
+  SmallVector<MedianComparator, 128> network;
+  getMedianNetwork(num, network);
+  for (auto &c : network) {
+    if (c.min && c.max) {
+      // T _cmp = min(med[i], med[j]);
+      // med[j] = max(med[i], med[j]);
+      // med[i] = _cmp;
+      VarDecl *cmp_decl = createVarDecl(Ctx, kernelDecl, "_cmp" +
+          std::to_string(literalCount++), QT, createMinMax(min_fun, c.i, c.j));
+      DC->addDecl(cmp_decl);
+      preStmts.push_back(createDeclStmt(Ctx, cmp_decl));
+      preCStmt.push_back(outerCStmt);
+      preStmts.push_back(createBinaryOperator(Ctx, accessValue(c.j),
+            createMinMax(max_fun, c.i, c.j), BO_Assign, QT));
+      preCStmt.push_back(outerCStmt);
+      preStmts.push_back(createBinaryOperator(Ctx, accessValue(c.i),
+            createDeclRefExpr(Ctx, cmp_decl), BO_Assign, QT));
+      preCStmt.push_back(outerCStmt);
+    } else if (c.min) {
+      // med[i] = min(med[i], med[j]);
+      preStmts.push_back(createBinaryOperator(Ctx, accessValue(c.i),
+            createMinMax(min_fun, c.i, c.j), BO_Assign, QT));
+      preCStmt.push_back(outerCStmt);
+    } else {
+      // med[j] = max(med[i], med[j]);
+      preStmts.push_back(createBinaryOperator(Ctx, accessValue(c.j),
+            createMinMax(max_fun, c.i, c.j), BO_Assign, QT));
+      preCStmt.push_back(outerCStmt);
+    }
+  }
+
+  // _tmp = med[num/2];
+  preStmts.push_back(createBinaryOperator(Ctx, tmp_var, accessValue(num/2),
+        BO_Assign, QT));
+  preCStmt.push_back(outerCStmt);
+}
+
+
+// index of the current iteration point within a Mask/Domain minus the given
+// offset: an integer literal when unrolled, based on the loop variable
+// otherwise
+Expr *ASTTranslate::getMaskIdx(int idx, Expr *idx_ref, int offset) {
+  if (!idx_ref) return createIntegerLiteral(Ctx, idx - offset);
+  if (!offset) return idx_ref;
+
+  return createParenExpr(Ctx, createBinaryOperator(Ctx, idx_ref,
+        createIntegerLiteral(Ctx, offset), BO_Sub, Ctx.IntTy));
+}
+
+
+// access table holding the constant coefficients of a Mask or the defined
+// points of a Domain: table[idx_y*width + idx_x]; the table is declared once
+// before the outermost loop
+Expr *ASTTranslate::accessMaskTable(HipaccMask *Mask, Expr *idx_x, Expr
+    *idx_y) {
+  assert(Mask->isConstant() && maskTableCStmt && "constant Mask in loop only");
+
+  if (!maskTables.count(Mask)) {
+    QualType QT = Mask->isDomain() ? Ctx.UnsignedCharTy : Mask->getType();
+    SmallVector<Expr *, 16> initExprs;
+    for (size_t y=0; y<Mask->getSizeY(); ++y) {
+      for (size_t x=0; x<Mask->getSizeX(); ++x) {
+        if (Mask->isDomain())
+          initExprs.push_back(createIntegerLiteral(Ctx,
+                static_cast<int32_t>(Mask->isDomainDefined(x, y))));
+        else
+          initExprs.push_back(Clone(Mask->getInitExpr(x, y)));
+      }
+    }
+
+    // const T _mask[size_y*size_x] = { ... };
+    QualType AT = Ctx.getConstantArrayType(QT.withConst(),
+        llvm::APInt(32, initExprs.size()), ArrayType::Normal, 0);
+    InitListExpr *init = new (Ctx) InitListExpr(Ctx, SourceLocation(),
+        initExprs, SourceLocation());
+    init->setType(AT);
+    VarDecl *table_decl = createVarDecl(Ctx, kernelDecl, (Mask->isDomain() ?
+          "_dom" : "_mask") + std::to_string(literalCount++), AT, init);
+    DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
+    DC->addDecl(table_decl);
+    preStmts.push_back(createDeclStmt(Ctx, table_decl));
+    preCStmt.push_back(maskTableCStmt);
+    maskTables[Mask] = createDeclRefExpr(Ctx, table_decl);
+  }
+
+  return accessArray(Ctx, maskTables[Mask], createBinaryOperator(Ctx,
+        createBinaryOperator(Ctx, idx_y, createIntegerLiteral(Ctx,
+            static_cast<int32_t>(Mask->getSizeX())), BO_Mul, Ctx.IntTy),
+        idx_x, BO_Add, Ctx.IntTy));
+}
+
+
+// iterate over Masks/Domains exceeding the unroll threshold of the target in
+// loops instead of unrolling them completely: the loop over x is partially
+// unrolled, remaining iterations are unrolled after that loop
+bool ASTTranslate::addConvolutionLoop(HipaccMask *Mask, const
+    std::function<Stmt *(int, int, Expr *, Expr *)> &cloneIteration,
+    CompoundStmt *outerCStmt) {
+  // hardware targets require fully unrolled windows
+  if (compilerOptions.emitVivado() || compilerOptions.emitOpenCLFPGA())
+    return false;
+  if (Mask->getSizeX() * Mask->getSizeY() <= Kernel->unroll_threshold)
+    return false;
+
+  // tables are declared before the outermost loop
+  auto outerTables = maskTables;
+  CompoundStmt *outerTableCStmt = maskTableCStmt;
+  if (!maskTableCStmt) maskTableCStmt = outerCStmt;
+
+  std::string lit(std::to_string(literalCount++));
+  VarDecl *x_decl = createVarDecl(Ctx, kernelDecl, "_mx" + lit, Ctx.IntTy,
+      createIntegerLiteral(Ctx, 0));
+  VarDecl *y_decl = createVarDecl(Ctx, kernelDecl, "_my" + lit, Ctx.IntTy,
+      createIntegerLiteral(Ctx, 0));
+  DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
+  DC->addDecl(x_decl);
+  DC->addDecl(y_decl);
+  DeclRefExpr *x_ref = createDeclRefExpr(Ctx, x_decl);
+  DeclRefExpr *y_ref = createDeclRefExpr(Ctx, y_decl);
+
+  int size_x = static_cast<int>(Mask->getSizeX());
+  int size_y = static_cast<int>(Mask->getSizeY());
+  int factor = std::max(1, static_cast<int>(Kernel->unroll_factor));
+  int loop_x = size_x - size_x % factor;
+
+  SmallVector<Stmt *, 16> body_x, body_y;
+  if (loop_x) {
+    // _mx, _mx + 1, ..., _mx + factor - 1
+    for (int k=0; k<factor; ++k) {
+      Expr *idx_x = x_ref;
+      if (k) idx_x = createParenExpr(Ctx, createBinaryOperator(Ctx, x_ref,
+            createIntegerLiteral(Ctx, k), BO_Add, Ctx.IntTy));
+      body_x.push_back(cloneIteration(k, 0, idx_x, y_ref));
+    }
+    // for (int _mx = 0; _mx < loop_x; _mx += factor)
+    body_y.push_back(createForStmt(Ctx, createDeclStmt(Ctx, x_decl),
+          createBinaryOperator(Ctx, x_ref, createIntegerLiteral(Ctx, loop_x),
+            BO_LT, Ctx.BoolTy), createCompoundAssignOperator(Ctx, x_ref,
+              createIntegerLiteral(Ctx, factor), BO_AddAssign, Ctx.IntTy),
+          createCompoundStmt(Ctx, body_x)));
+  }
+  for (int x=loop_x; x<size_x; ++x)
+    body_y.push_back(cloneIteration(x, 0, nullptr, y_ref));
+
+  // for (int _my = 0; _my < size_y; ++_my)
+  preStmts.push_back(createForStmt(Ctx, createDeclStmt(Ctx, y_decl),
+        createBinaryOperator(Ctx, y_ref, createIntegerLiteral(Ctx, size_y),
+          BO_LT, Ctx.BoolTy), createUnaryOperator(Ctx, y_ref, UO_PreInc,
+            Ctx.IntTy), createCompoundStmt(Ctx, body_y)));
+  preCStmt.push_back(outerCStmt);
+
+  maskTables = outerTables;
+  maskTableCStmt = outerTableCStmt;
+
+  return true;
+}
+
+
 // check if we have a convolve/reduce/iterate method and convert it
 Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
   enum class Method : uint8_t {
@@ -419,25 +1746,33 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
   Expr *init = nullptr;
   switch (method) {
     case Method::Convolve:
-      init = getInitExpr(convMode, LE->getCallOperator()->getReturnType());
+      if (convMode != Reduce::MEDIAN)
+        init = getInitExpr(convMode, LE->getCallOperator()->getReturnType());
       break;
     case Method::Reduce:
-      init = getInitExpr(redModes.back(),
-          LE->getCallOperator()->getReturnType());
+      if (redModes.back() != Reduce::MEDIAN)
+        init = getInitExpr(redModes.back(),
+            LE->getCallOperator()->getReturnType());
       break;
     case Method::Iterate: break;
   }
+  // value range of partial sums, if known
+  auto interval = convIntervals.find(E);
+  QualType tmp_type = LE->getCallOperator()->getReturnType();
+  if (interval != convIntervals.end())
+    tmp_type = getIntervalType(interval->second, tmp_type);
   std::string tmp_lit("_tmp" + std::to_string(literalCount++));
-  VarDecl *tmp_decl = createVarDecl(Ctx, kernelDecl, tmp_lit,
-      LE->getCallOperator()->getReturnType(), init);
+  VarDecl *tmp_decl = createVarDecl(Ctx, kernelDecl, tmp_lit, tmp_type, init);
   DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
   DC->addDecl(tmp_decl);
   DeclRefExpr *tmp_dre = createDeclRefExpr(Ctx, tmp_decl);
 
-  if (compilerOptions.emitOpenCLFPGA()) {
+  if (compilerOptions.emitOpenCLFPGA() || compilerOptions.emitVivado()) {
     // check if bit width reduction is specified and add to temporary variable
     size_t lineNum = Ctx.getFullLoc(E->getLocStart()).getExpansionLineNumber();
     int bwMask = getBitwidthMask(lineNum, E->getDirectCallee()->getName());
+    if (bwMask == 0 && interval != convIntervals.end())
+      bwMask = getIntervalBitwidthMask(interval->second, tmp_type);
     if (bwMask != 0) bwMapTmp[tmp_decl->getNameAsString()] = bwMask;
   }
 
@@ -471,8 +1806,88 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
       break;
   }
 
-  // unroll Mask/Domain
+  // values of median convolutions/reductions are stored and the median is
+  // selected after the last iteration
+  bool median = (method==Method::Convolve && convMode==Reduce::MEDIAN) ||
+                (method==Method::Reduce && redModes.back()==Reduce::MEDIAN);
+  if (median) addMedianValues(Mask, FD, LE, tmp_dre, outerCompountStmt);
+
+  // constant Domains with undefined iteration points require a check when
+  // iterating in loops
+  bool domain_holes = false;
   for (size_t y=0; y<Mask->getSizeY(); ++y) {
+    for (size_t x=0; x<Mask->getSizeX(); ++x) {
+      if (Mask->isDomain() && Mask->isConstant() &&
+          !Mask->isDomainDefined(x, y)) {
+        domain_holes = true;
+      }
+    }
+  }
+
+  // clone lambda-function for an iteration point: the point is given by the
+  // literal indices x and y or by the loop variables x_ref and y_ref
+  auto cloneIteration = [&] (int x, int y, Expr *x_ref, Expr *y_ref) {
+    Stmt *iteration = nullptr;
+    switch (method) {
+      case Method::Convolve:
+        convIdxX = x;
+        convIdxY = y;
+        convIdxXRef = x_ref;
+        convIdxYRef = y_ref;
+        iteration = Clone(LE->getBody());
+        convIdxXRef = convIdxYRef = nullptr;
+        break;
+      case Method::Reduce:
+      case Method::Iterate:
+        redIdxX.push_back(x);
+        redIdxY.push_back(y);
+        redIdxXRef.push_back(x_ref);
+        redIdxYRef.push_back(y_ref);
+        iteration = Clone(LE->getBody());
+        // add check if this iteration point should be processed - the
+        // DeclRefExpr for the Domain is retrieved when visiting the
+        // MemberExpr
+        if (!Mask->isConstant()) {
+          // set Domain as being used within Kernel
+          Kernel->setUsed(FD->getNameAsString());
+          iteration = addDomainCheck(Mask,
+              dyn_cast_or_null<DeclRefExpr>(VisitMemberExpr(ME)),
+              iteration);
+        } else if (domain_holes && (x_ref || y_ref)) {
+          // if (_dom[y*width + x])
+          iteration = createIfStmt(Ctx, accessMaskTable(Mask,
+                getMaskIdx(x, x_ref), getMaskIdx(y, y_ref)), iteration);
+        }
+        redIdxX.pop_back();
+        redIdxY.pop_back();
+        redIdxXRef.pop_back();
+        redIdxYRef.pop_back();
+        break;
+    }
+    // clear decls added while cloning last iteration
+    LambdaDeclMap.clear();
+    return iteration;
+  };
+
+  // separable convolutions and reductions are computed in a row and a column
+  // pass, other constant masks are unrolled according to their coefficients
+  // unless they exceed the unroll threshold and are iterated in loops
+  bool large = Mask->getSizeX() * Mask->getSizeY() > Kernel->unroll_threshold;
+  bool unrolled = false;
+  if (method==Method::Convolve || method==Method::Reduce)
+    unrolled = addSeparableConvolution(E, Mask, LE, outerCompountStmt);
+  if (!unrolled && method==Method::Convolve && !large)
+    unrolled = addFactoredConvolution(Mask, LE, outerCompountStmt);
+  if (!unrolled && !median)
+    unrolled = addConvolutionLoop(Mask, cloneIteration, outerCompountStmt);
+  if (!unrolled && median && medianValues[tmp_dre].sliding) {
+    preStmts.push_back(addMedianSlidingWindow(Mask, tmp_dre, cloneIteration));
+    preCStmt.push_back(outerCompountStmt);
+    unrolled = true;
+  }
+
+  // unroll Mask/Domain
+  for (size_t y=0; y<Mask->getSizeY() && !unrolled; ++y) {
     for (size_t x=0; x<Mask->getSizeX(); ++x) {
       bool doIterate = true;
 
@@ -482,40 +1897,15 @@ Expr *ASTTranslate::convertConvolution(CXXMemberCallExpr *E) {
       }
 
       if (doIterate) {
-        Stmt *iteration = nullptr;
-        switch (method) {
-          case Method::Convolve:
-            convIdxX = x;
-            convIdxY = y;
-            iteration = Clone(LE->getBody());
-            break;
-          case Method::Reduce:
-          case Method::Iterate:
-            redIdxX.push_back(x);
-            redIdxY.push_back(y);
-            iteration = Clone(LE->getBody());
-            // add check if this iteration point should be processed - the
-            // DeclRefExpr for the Domain is retrieved when visiting the
-            // MemberExpr
-            if (!Mask->isConstant()) {
-              // set Domain as being used within Kernel
-              Kernel->setUsed(FD->getNameAsString());
-              iteration = addDomainCheck(Mask,
-                  dyn_cast_or_null<DeclRefExpr>(VisitMemberExpr(ME)),
-                  iteration);
-            }
-            redIdxX.pop_back();
-            redIdxY.pop_back();
-            break;
-        }
-        preStmts.push_back(iteration);
+        preStmts.push_back(cloneIteration(x, y, nullptr, nullptr));
         preCStmt.push_back(outerCompountStmt);
-        // clear decls added while cloning last iteration
-        LambdaDeclMap.clear();
+        if (median) medianValues[tmp_dre].index++;
       }
     }
   }
 
+  if (median) addMedianSelection(tmp_dre, outerCompountStmt);
+
   // reset global variables
   switch (method) {
     case Method::Convolve:
@@ -46,7 +46,8 @@ std::string ASTTranslate::getInterpolationName(CompilerOptions &compilerOptions,
 
   switch (Acc->getInterpolationMode()) {
     case Interpolate::NO:
-    case Interpolate::NN:                break;
+    case Interpolate::NN:
+    case Interpolate::RS:                break;
     case Interpolate::LF: name += "lf_"; break;
     case Interpolate::CF: name += "cf_"; break;
     case Interpolate::L3: name += "l3_"; break;
@@ -156,6 +156,18 @@ Expr *ASTTranslate::accessMem(DeclRefExpr *LHS, HipaccAccessor *Acc,
           createParenExpr(Ctx, addNNInterpolationY(Acc, idx_y)), nullptr,
           Ctx.getTrivialTypeSourceInfo(Ctx.IntTy));
       break;
+    case Interpolate::RS:
+      // resample gid_[x|y], but not the local offset:
+      // (int)(acc_scale_x * (gid_x - is_offset_x)) + local_offset_x
+      idx_x = addLocalOffset(createCStyleCastExpr(Ctx, Ctx.IntTy,
+            CK_FloatingToIntegral, createParenExpr(Ctx,
+              addNNInterpolationX(Acc, tileVars.global_id_x)), nullptr,
+            Ctx.getTrivialTypeSourceInfo(Ctx.IntTy)), local_offset_x);
+      idx_y = addLocalOffset(createCStyleCastExpr(Ctx, Ctx.IntTy,
+            CK_FloatingToIntegral, createParenExpr(Ctx,
+              addNNInterpolationY(Acc, gidYRef)), nullptr,
+            Ctx.getTrivialTypeSourceInfo(Ctx.IntTy)), local_offset_y);
+      break;
     case Interpolate::LF:
     case Interpolate::CF:
     case Interpolate::L3:
@@ -193,7 +205,7 @@ Expr *ASTTranslate::accessMem(DeclRefExpr *LHS, HipaccAccessor *Acc,
     case READ_ONLY:
       switch (compilerOptions.getTargetLang()) {
         case Language::C99:
-          return accessMem2DAt(LHS, idx_x, idx_y);
+          return accessMemArrAt(LHS, getStrideDecl(Acc), idx_x, idx_y);
         case Language::CUDA:
           if (Kernel->useTextureMemory(Acc) == Texture::None)
             return accessMemArrAt(LHS, getStrideDecl(Acc), idx_x, idx_y);
@@ -236,11 +248,61 @@ Expr *ASTTranslate::accessMem(DeclRefExpr *LHS, HipaccAccessor *Acc,
 // access 1D memory array at given index
 Expr *ASTTranslate::accessMemArrAt(DeclRefExpr *LHS, Expr *stride, Expr *idx_x,
     Expr *idx_y) {
+  // C/C++: compute pixels of fused kernels instead of reading their output
+  if (compilerOptions.emitC99()) {
+    for (auto img : KernelClass->getImgFields()) {
+      if (img->getName() != LHS->getNameInfo().getAsString())
+        continue;
+
+      HipaccAccessor *Acc = Kernel->getImgFromMapping(img);
+      if (HipaccKernel *FK = Kernel->getFusedKernel(Acc)) {
+        // C/C++: ProducerKernelPixel(args..., idx_x, idx_y)
+        // local operators read rows of the producer from a line buffer, which
+        // holds as many rows as the window of the accessor:
+        // C/C++: ProducerKernelLine(args..., rows, idx_x, idx_y)
+        bool useLineBuffer = Acc->getBoundaryMode() != Boundary::UNDEFINED &&
+          Acc->getSizeY() > 1 &&
+          !(KernelClass->getMemPattern(img) & USER_XY);
+        SmallVector<std::pair<QualType, std::string>, 16> fusedArgs;
+        SmallVector<QualType, 16> argTypes;
+        SmallVector<std::string, 16> argNames;
+        SmallVector<Expr *, 16> args;
+
+        FK->getFusedArgs(FK->getName() + "_", fusedArgs);
+        for (auto arg : fusedArgs) {
+          argTypes.push_back(arg.first);
+          argNames.push_back(arg.second);
+          args.push_back(createDeclRefExpr(Ctx, createVarDecl(Ctx, kernelDecl,
+                  arg.second, arg.first)));
+        }
+        if (useLineBuffer) {
+          argTypes.push_back(Ctx.IntTy);
+          argNames.push_back("_rows");
+          args.push_back(createIntegerLiteral(Ctx,
+                static_cast<int>(Acc->getSizeY())));
+        }
+        argTypes.push_back(Ctx.IntTy);
+        argNames.push_back("gid_x");
+        args.push_back(idx_x);
+        argTypes.push_back(Ctx.IntTy);
+        argNames.push_back("gid_y");
+        args.push_back(idx_y);
+
+        FunctionDecl *pixelFD = createFunctionDecl(Ctx,
+            Ctx.getTranslationUnitDecl(),
+            useLineBuffer ? FK->getLineName() : FK->getPixelName(),
+            FK->getIterationSpace()->getImage()->getType(), argTypes,
+            argNames);
+        return createFunctionCall(Ctx, pixelFD, args);
+      }
+    }
+  }
+
   // mark image as being used within the kernel
   Kernel->setUsed(LHS->getNameInfo().getAsString());
 
   // for vectorization divide stride by vector size
-  if (Kernel->vectorize()) {
+  if (Kernel->vectorize() && !compilerOptions.emitC99()) {
     stride = createBinaryOperator(Ctx, stride, createIntegerLiteral(Ctx, 4),
         BO_Div, Ctx.IntTy);
   }
@@ -0,0 +1,513 @@
+//
+// Copyright (c) 2013, University of Erlangen-Nuremberg
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+//===--- RangeTable.cpp - Lookup Tables for Range-Dependent Values --------===//
+//
+// This file implements the evaluation of math functions on pixel values of
+// 8/16-bit images (e.g. range weights of bilateral filters) through tables
+// computed once per kernel invocation.
+//
+//===----------------------------------------------------------------------===//
+
+#include "hipacc/AST/ASTTranslate.h"
+
+using namespace clang;
+using namespace hipacc;
+using namespace ASTNode;
+
+// maximal number of table entries: tables of GPU targets are stored in
+// shared/local memory and filled cooperatively by all threads of a block,
+// which covers differences of 8-bit values
+static const int64_t max_range_cpu = 1 << 17;
+static const int64_t max_range_gpu = 2048;
+
+
+// types that represent all values of an index without loss
+static bool keepsRange(ASTContext &Ctx, QualType QT) {
+  if (QT->isRealFloatingType()) return true;
+  return QT->isIntegerType() && !QT->isBooleanType() &&
+         Ctx.getTypeSize(QT) >= 32;
+}
+
+
+// add constant to index: idx + val
+static Expr *addIndexOffset(ASTContext &Ctx, Expr *idx, int64_t val) {
+  if (val > 0)
+    return createBinaryOperator(Ctx, idx, createIntegerLiteral(Ctx,
+          static_cast<int32_t>(val)), BO_Add, Ctx.IntTy);
+  if (val < 0)
+    return createBinaryOperator(Ctx, idx, createIntegerLiteral(Ctx,
+          static_cast<int32_t>(-val)), BO_Sub, Ctx.IntTy);
+  return idx;
+}
+
+
+// table access: table[idx]
+static Expr *accessTable(ASTContext &Ctx, DeclRefExpr *table, Expr *idx) {
+  if (auto PT = table->getType()->getAs<PointerType>())
+    return new (Ctx) ArraySubscriptExpr(createImplicitCastExpr(Ctx,
+          table->getType(), CK_LValueToRValue, table, nullptr, VK_RValue),
+        idx, PT->getPointeeType(), VK_LValue, OK_Ordinary, SourceLocation());
+
+  QualType QT = Ctx.getAsArrayType(table->getType())->getElementType();
+  return new (Ctx) ArraySubscriptExpr(createImplicitCastExpr(Ctx,
+        Ctx.getPointerType(QT), CK_ArrayToPointerDecay, table, nullptr,
+        VK_RValue), idx, QT, VK_LValue, OK_Ordinary, SourceLocation());
+}
+
+
+// collect variables that are assigned, incremented, or referenced after
+// their declaration; only reads are allowed for variables being inlined
+static void collectModifiedVars(Stmt *S, llvm::SmallPtrSet<VarDecl *, 16>
+    &vars, bool read=false) {
+  if (!S) return;
+
+  if (auto DRE = dyn_cast<DeclRefExpr>(S)) {
+    if (auto VD = dyn_cast<VarDecl>(DRE->getDecl()))
+      if (!read) vars.insert(VD);
+    return;
+  }
+
+  // captures are references to the variables, check only the body
+  if (auto LE = dyn_cast<LambdaExpr>(S)) {
+    collectModifiedVars(LE->getBody(), vars);
+    return;
+  }
+
+  bool sub_read = false;
+  if (auto ICE = dyn_cast<ImplicitCastExpr>(S))
+    sub_read = ICE->getCastKind() == CK_LValueToRValue;
+  if (isa<ParenExpr>(S))
+    sub_read = read;
+
+  for (auto child : S->children())
+    collectModifiedVars(child, vars, sub_read);
+}
+
+
+// side effect-free math functions
+bool ASTTranslate::isMathFunction(FunctionDecl *FD) {
+  if (!FD || !FD->getIdentifier()) return false;
+
+  DeclContext *DC = FD->getEnclosingNamespaceContext();
+  if (DC->isNamespace() && cast<NamespaceDecl>(DC)->getCanonicalDecl() ==
+      hipacc_math_ns->getCanonicalDecl())
+    return true;
+
+  return builtins.getBuiltinFunction(FD->getName(), FD->getReturnType(),
+      Language::CUDA) != nullptr;
+}
+
+
+// classify expression: invariant during kernel execution, an index of
+// limited integer range (pixel value or difference of pixel values), or a
+// function depending only on one index
+ASTTranslate::RangeValue ASTTranslate::classifyRange(Expr *E) {
+  E = E->IgnoreParens();
+
+  if (isa<IntegerLiteral>(E) || isa<FloatingLiteral>(E) ||
+      isa<CharacterLiteral>(E))
+    return RangeValue(RangeValue::Invariant);
+
+  // scalar kernel members are constant
+  if (auto ME = dyn_cast<MemberExpr>(E)) {
+    if (isa<FieldDecl>(ME->getMemberDecl()) &&
+        isa<CXXThisExpr>(ME->getBase()->IgnoreImpCasts()) &&
+        ME->getType()->isArithmeticType())
+      return RangeValue(RangeValue::Invariant);
+    return RangeValue();
+  }
+
+  if (auto CE = dyn_cast<CastExpr>(E)) {
+    if (!E->getType()->isArithmeticType()) return RangeValue();
+
+    RangeValue RV = classifyRange(CE->getSubExpr());
+    if (RV.kind == RangeValue::Index && !keepsRange(Ctx, E->getType()))
+      return RangeValue();
+    return RV;
+  }
+
+  // local variables which are only read: inlined when computing tables
+  if (auto DRE = dyn_cast<DeclRefExpr>(E)) {
+    auto VD = dyn_cast<VarDecl>(DRE->getDecl());
+    if (!VD || !VD->isLocalVarDecl() || VD->isStaticLocal() ||
+        !VD->getInit() || !VD->getType()->isArithmeticType() ||
+        rangeModified.count(VD))
+      return RangeValue();
+
+    RangeValue RV = classifyRange(VD->getInit());
+    switch (RV.kind) {
+      default: break;
+      case RangeValue::Index:
+        if (!keepsRange(Ctx, VD->getType())) return RangeValue();
+        RV.key = VD;
+        RV.index = DRE;
+        break;
+      case RangeValue::Dependent:
+        // math functions in the initialization get a table on their own
+        RV.call = false;
+        break;
+    }
+    return RV;
+  }
+
+  // Accessor read of an 8/16-bit image
+  if (auto OCE = dyn_cast<CXXOperatorCallExpr>(E)) {
+    auto ME = dyn_cast<MemberExpr>(OCE->getArg(0));
+    FieldDecl *FD = ME ? dyn_cast<FieldDecl>(ME->getMemberDecl()) : nullptr;
+    QualType QT = E->getType();
+    if (!FD || !Kernel->getImgFromMapping(FD) || !QT->isIntegerType() ||
+        QT->isBooleanType() || Ctx.getTypeSize(QT) > 16)
+      return RangeValue();
+
+    int64_t bits = Ctx.getTypeSize(QT);
+    RangeValue RV(RangeValue::Index);
+    RV.key = E;
+    RV.index = E;
+    if (QT->isSignedIntegerType()) {
+      RV.lo = -(int64_t(1) << (bits-1));
+      RV.hi = (int64_t(1) << (bits-1)) - 1;
+    } else {
+      RV.lo = 0;
+      RV.hi = (int64_t(1) << bits) - 1;
+    }
+    return RV;
+  }
+
+  if (auto UO = dyn_cast<UnaryOperator>(E)) {
+    if (UO->getOpcode() != UO_Minus && UO->getOpcode() != UO_Plus)
+      return RangeValue();
+
+    RangeValue RV = classifyRange(UO->getSubExpr());
+    if (RV.kind == RangeValue::Index && UO->getOpcode() == UO_Minus)
+      RV.kind = RangeValue::Dependent;
+    return RV;
+  }
+
+  if (auto BO = dyn_cast<BinaryOperator>(E)) {
+    switch (BO->getOpcode()) {
+      default: return RangeValue();
+      case BO_Add:
+      case BO_Sub:
+      case BO_Mul:
+      case BO_Div:
+        break;
+    }
+
+    RangeValue LHS = classifyRange(BO->getLHS());
+    RangeValue RHS = classifyRange(BO->getRHS());
+    if (LHS.kind == RangeValue::Unknown || RHS.kind == RangeValue::Unknown)
+      return RangeValue();
+    if (RHS.kind == RangeValue::Invariant && LHS.kind ==
+        RangeValue::Invariant)
+      return LHS;
+
+    // difference of two indices, e.g. in(dom) - in()
+    if (BO->getOpcode() == BO_Sub && LHS.kind == RangeValue::Index &&
+        RHS.kind == RangeValue::Index && LHS.key != RHS.key &&
+        keepsRange(Ctx, E->getType())) {
+      RangeValue RV(RangeValue::Index);
+      RV.key = E;
+      RV.index = E;
+      RV.lo = LHS.lo - RHS.hi;
+      RV.hi = LHS.hi - RHS.lo;
+      return RV;
+    }
+
+    // integer division by an index, which may be zero while computing the
+    // table, e.g. 1/(in(dom) - in())
+    if (BO->getOpcode() == BO_Div && RHS.kind != RangeValue::Invariant &&
+        !E->getType()->isRealFloatingType())
+      return RangeValue();
+
+    RangeValue RV = LHS.kind == RangeValue::Invariant ? RHS : LHS;
+    if (LHS.kind != RangeValue::Invariant &&
+        RHS.kind != RangeValue::Invariant && LHS.key != RHS.key)
+      return RangeValue();
+    RV.kind = RangeValue::Dependent;
+    RV.call = LHS.call || RHS.call;
+    return RV;
+  }
+
+  if (auto CE = dyn_cast<CallExpr>(E)) {
+    if (isa<CXXMemberCallExpr>(CE) || !isMathFunction(CE->getDirectCallee()))
+      return RangeValue();
+
+    RangeValue RV(RangeValue::Invariant);
+    for (auto arg : CE->arguments()) {
+      RangeValue ARG = classifyRange(arg);
+      if (ARG.kind == RangeValue::Unknown) return RangeValue();
+      if (ARG.kind == RangeValue::Invariant) continue;
+      if (RV.kind != RangeValue::Invariant && RV.key != ARG.key)
+        return RangeValue();
+      RV = ARG;
+    }
+    if (RV.kind != RangeValue::Invariant) {
+      RV.kind = RangeValue::Dependent;
+      RV.call = true;
+    }
+    return RV;
+  }
+
+  return RangeValue();
+}
+
+
+// search for the outermost expressions calling math functions which depend
+// only on one index of limited range
+void ASTTranslate::findRangeTables(Stmt *S, int64_t max_size) {
+  if (!S) return;
+
+  if (auto LE = dyn_cast<LambdaExpr>(S)) {
+    findRangeTables(LE->getBody(), max_size);
+    return;
+  }
+
+  if (auto E = dyn_cast<Expr>(S)) {
+    RangeValue RV = classifyRange(E);
+    if (RV.kind == RangeValue::Dependent && RV.call &&
+        E->getType()->isRealFloatingType() && RV.hi - RV.lo < max_size) {
+      RangeTable RT;
+      RT.expr = E;
+      RT.index = RV.index;
+      RT.key = RV.key;
+      RT.lo = RV.lo;
+      RT.hi = RV.hi;
+      RT.table = nullptr;
+      rangeTableMap[E] = rangeTables.size();
+      rangeTables.push_back(RT);
+      return;
+    }
+  }
+
+  for (auto child : S->children())
+    findRangeTables(child, max_size);
+}
+
+
+// declare and compute lookup tables at the beginning of the kernel:
+// T _range[hi - lo + 1];
+// for (int _ri = 0; _ri < hi - lo + 1; ++_ri) _range[_ri] = f(_ri + lo);
+// GPU targets store the tables in shared/local memory; each thread of a
+// block computes a subset of the entries. C/C++ tables exceed the stack and
+// are kept on the heap per thread calling the kernel:
+// static thread_local HipaccRangeTable<T> _table;
+// T *_range = hipaccGetRangeTable(_table, hi - lo + 1);
+void ASTTranslate::addRangeTables(Stmt *S, SmallVector<Stmt *, 16>
+    &kernelBody, FunctionDecl *barrier) {
+  rangeTables.clear();
+  rangeTableMap.clear();
+  rangeModified.clear();
+
+  int64_t max_size = 0;
+  switch (compilerOptions.getTargetLang()) {
+    case Language::C99:
+      // per-pixel functions of fused kernels are called for each pixel
+      if (!Kernel->isFused()) max_size = max_range_cpu;
+      break;
+    case Language::CUDA:
+    case Language::OpenCLACC:
+    case Language::OpenCLCPU:
+    case Language::OpenCLGPU:
+      max_size = max_range_gpu;
+      break;
+    case Language::OpenCLFPGA:
+    case Language::Renderscript:
+    case Language::Filterscript:
+    case Language::Vivado:
+      break;
+  }
+  if (!max_size || Kernel->vectorize()) return;
+
+  collectModifiedVars(S, rangeModified);
+  findRangeTables(S, max_size);
+  if (rangeTables.empty()) return;
+
+  DeclContext *DC = FunctionDecl::castToDeclContext(kernelDecl);
+  for (auto &RT : rangeTables) {
+    std::string lit(std::to_string(literalCount++));
+    int64_t size = RT.hi - RT.lo + 1;
+
+    VarDecl *table_decl = nullptr;
+    QualType QT = Ctx.getConstantArrayType(RT.expr->getType(),
+        llvm::APInt(32, size), ArrayType::Normal, 0);
+    switch (compilerOptions.getTargetLang()) {
+      default:
+        table_decl = createVarDecl(Ctx, DC, "_range" + lit, QT, nullptr);
+        break;
+      case Language::C99: {
+          RecordDecl *table_class = createRecordDecl(Ctx,
+              Ctx.getTranslationUnitDecl(), "HipaccRangeTable", TTK_Class,
+              ArrayRef<QualType>(), ArrayRef<StringRef>());
+          TypedefDecl *table_type = TypedefDecl::Create(Ctx,
+              Ctx.getTranslationUnitDecl(), SourceLocation(), SourceLocation(),
+              &Ctx.Idents.get("HipaccRangeTable<" +
+                RT.expr->getType().getAsString() + ">"),
+              Ctx.getTrivialTypeSourceInfo(Ctx.getRecordType(table_class)));
+          VarDecl *storage_decl = createVarDecl(Ctx, DC, "_table" + lit,
+              Ctx.getTypeDeclType(table_type));
+          storage_decl->setStorageClass(SC_Static);
+          storage_decl->setTSCSpec(TSCS_thread_local);
+          DC->addDecl(storage_decl);
+          kernelBody.push_back(createDeclStmt(Ctx, storage_decl));
+
+          QualType PT = Ctx.getPointerType(RT.expr->getType());
+          SmallVector<QualType, 16> argTypes;
+          SmallVector<std::string, 16> argNames;
+          SmallVector<Expr *, 16> args;
+          argTypes.push_back(storage_decl->getType());
+          argNames.push_back("table");
+          args.push_back(createDeclRefExpr(Ctx, storage_decl));
+          argTypes.push_back(Ctx.IntTy);
+          argNames.push_back("size");
+          args.push_back(createIntegerLiteral(Ctx,
+                static_cast<int32_t>(size)));
+          FunctionDecl *get_table = createFunctionDecl(Ctx,
+              Ctx.getTranslationUnitDecl(), "hipaccGetRangeTable", PT,
+              argTypes, argNames);
+          table_decl = createVarDecl(Ctx, DC, "_range" + lit, PT,
+              createFunctionCall(Ctx, get_table, args));
+        }
+        break;
+      case Language::CUDA:
+#ifndef WIN32
+        table_decl = createVarDecl(Ctx, DC, "_range" + lit, QT, nullptr);
+        table_decl->addAttr(CUDASharedAttr::CreateImplicit(Ctx));
+#else // WIN32
+        table_decl = createVarDecl(Ctx, DC, "_range" + lit,
+            Ctx.getAddrSpaceQualType(QT, LangAS::cuda_shared), nullptr);
+#endif // WIN32
+        break;
+      case Language::OpenCLACC:
+      case Language::OpenCLCPU:
+      case Language::OpenCLGPU:
+        table_decl = createVarDecl(Ctx, DC, "_range" + lit,
+            Ctx.getAddrSpaceQualType(QT, LangAS::opencl_local), nullptr);
+        break;
+    }
+    DC->addDecl(table_decl);
+    kernelBody.push_back(createDeclStmt(Ctx, table_decl));
+    RT.table = createDeclRefExpr(Ctx, table_decl);
+
+    // first entry and step of the current thread
+    Expr *first = createIntegerLiteral(Ctx, 0);
+    Expr *step = nullptr;
+    if (!compilerOptions.emitC99()) {
+      first = createBinaryOperator(Ctx, createBinaryOperator(Ctx,
+            tileVars.local_id_y, tileVars.local_size_x, BO_Mul, Ctx.IntTy),
+          tileVars.local_id_x, BO_Add, Ctx.IntTy);
+      step = createBinaryOperator(Ctx, tileVars.local_size_x,
+          tileVars.local_size_y, BO_Mul, Ctx.IntTy);
+    }
+    VarDecl *idx_decl = createVarDecl(Ctx, kernelDecl, "_ri" + lit, Ctx.IntTy,
+        first);
+    DC->addDecl(idx_decl);
+    DeclRefExpr *idx_ref = createDeclRefExpr(Ctx, idx_decl);
+
+    // substitute the index by its value: (T)(_ri + lo)
+    QualType IT = RT.index->getType();
+    rangeSubst[RT.key] = createCStyleCastExpr(Ctx, IT,
+        IT->isRealFloatingType() ? CK_IntegralToFloating : CK_IntegralCast,
+        createParenExpr(Ctx, addIndexOffset(Ctx, idx_ref, RT.lo)), nullptr,
+        Ctx.getTrivialTypeSourceInfo(IT));
+    Expr *value = Clone(RT.expr);
+    rangeSubst.clear();
+
+    Expr *inc = step ? static_cast<Expr *>(createCompoundAssignOperator(Ctx,
+          idx_ref, step, BO_AddAssign, Ctx.IntTy)) :
+      static_cast<Expr *>(createUnaryOperator(Ctx, idx_ref, UO_PreInc,
+            Ctx.IntTy));
+    kernelBody.push_back(createForStmt(Ctx, createDeclStmt(Ctx, idx_decl),
+          createBinaryOperator(Ctx, idx_ref, createIntegerLiteral(Ctx,
+              static_cast<int32_t>(size)), BO_LT, Ctx.BoolTy), inc,
+          createBinaryOperator(Ctx, accessTable(Ctx, RT.table, idx_ref), value,
+            BO_Assign, RT.expr->getType())));
+  }
+
+  // synchronize shared/local memory
+  SmallVector<Expr *, 16> args;
+  switch (compilerOptions.getTargetLang()) {
+    default: break;
+    case Language::CUDA:
+      kernelBody.push_back(createFunctionCall(Ctx, barrier, args));
+      break;
+    case Language::OpenCLACC:
+    case Language::OpenCLCPU:
+    case Language::OpenCLGPU:
+      // CLK_LOCAL_MEM_FENCE -> 1
+      args.push_back(createIntegerLiteral(Ctx, 1));
+      kernelBody.push_back(createFunctionCall(Ctx, barrier, args));
+      break;
+  }
+}
+
+
+// replace expressions by table lookups: table[(int)(index) - lo]; while
+// computing the tables, substitute the index by the table position and
+// inline local variables
+Stmt *ASTTranslate::cloneRange(Stmt *S) {
+  auto E = dyn_cast<Expr>(S);
+  if (!E || astMode != TranslateAST) return nullptr;
+
+  if (rangeSubst.empty()) {
+    auto it = rangeTableMap.find(E);
+    if (it == rangeTableMap.end()) return nullptr;
+
+    RangeTable &RT = rangeTables[it->second];
+    Expr *idx = Clone(RT.index);
+    QualType IT = RT.index->getType();
+    if (idx->isGLValue())
+      idx = createImplicitCastExpr(Ctx, IT, CK_LValueToRValue, idx, nullptr,
+          VK_RValue);
+    idx = createCStyleCastExpr(Ctx, Ctx.IntTy, IT->isRealFloatingType() ?
+        CK_FloatingToIntegral : CK_IntegralCast, createParenExpr(Ctx, idx),
+        nullptr, Ctx.getTrivialTypeSourceInfo(Ctx.IntTy));
+
+    return createImplicitCastExpr(Ctx, E->getType(), CK_LValueToRValue,
+        accessTable(Ctx, RT.table, addIndexOffset(Ctx, idx, -RT.lo)), nullptr,
+        VK_RValue);
+  }
+
+  Expr *sub = E;
+  if (auto ICE = dyn_cast<ImplicitCastExpr>(E))
+    if (ICE->getCastKind() == CK_LValueToRValue)
+      sub = ICE->getSubExpr()->IgnoreParens();
+
+  const void *key = sub;
+  auto DRE = dyn_cast<DeclRefExpr>(sub);
+  if (DRE) key = DRE->getDecl();
+
+  auto it = rangeSubst.find(key);
+  if (it != rangeSubst.end()) return it->second;
+
+  if (DRE)
+    if (auto VD = dyn_cast<VarDecl>(DRE->getDecl()))
+      if (VD->isLocalVarDecl())
+        return createParenExpr(Ctx, Clone(VD->getInit()));
+
+  return nullptr;
+}
+
+// vim: set ts=2 sw=2 sts=2 et ai:
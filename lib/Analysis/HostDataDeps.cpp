@@ -182,13 +182,23 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
         // TODO: Read from arguments
         Interpolate mode = Interpolate::NO;
 
+        if (DRE == nullptr) {
+          dataDeps.setUnsupported("First Accessor argument is not a BC or Image");
+          break;
+        }
+
         Acc = new HipaccAccessor(VD, BC, mode, false);
 
         // store Accessor definition
         accDeclMap_[VD] = Acc;
 
-        assert(DRE != nullptr && "First Accessor argument is not a BC or Image");
-        dataDeps.addAccessor(VD, Acc, DRE->getDecl());
+        // accessors without crop and interpolation read the image at the
+        // coordinates of the iteration space
+        bool direct = true;
+        for (size_t i=1; i<CCE->getNumArgs(); ++i)
+          direct &= isa<CXXDefaultArgExpr>(CCE->getArg(i));
+
+        dataDeps.addAccessor(VD, Acc, DRE->getDecl(), direct);
 
         break;
       }
@@ -218,7 +228,8 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
             Img = imgDeclMap_[DRE->getDecl()];
             IS = new HipaccIterationSpace(VD, Img, false);
 
-            dataDeps.addIterationSpace(VD, IS, DRE->getDecl());
+            dataDeps.addIterationSpace(VD, IS, DRE->getDecl(),
+                CCE->getNumArgs() == 1);
           }
         }
 
@@ -264,7 +275,10 @@ void DependencyTracker::VisitDeclStmt(DeclStmt *S) {
                 << " " << varName
                 << std::endl;
 
-        CXXConstructExpr *CCE = dyn_cast<CXXConstructExpr>(VD->getInit());
+        CXXConstructExpr *CCE =
+            dyn_cast_or_null<CXXConstructExpr>(VD->getInit());
+        if (!CCE || !CCE->getNumArgs())
+          break;
         Expr *Arg0 = CCE->getArg(0)->IgnoreImpCasts();
 
         if (isa<DeclRefExpr>(Arg0)) {
@@ -313,7 +327,7 @@ void DependencyTracker::VisitCXXMemberCallExpr(CXXMemberCallExpr *E) {
           if (DEBUG) std::cout << "  Tracked Kernel call: "
                   << className << " " << varName
                   << std::endl;
-          dataDeps.runKernel(DRE->getDecl());
+          dataDeps.runKernel(DRE->getDecl(), E->getLocStart());
         }
       }
     }
@@ -321,6 +335,40 @@ void DependencyTracker::VisitCXXMemberCallExpr(CXXMemberCallExpr *E) {
 }
 
 
+void DependencyTracker::trackHostUses(Stmt *S) {
+  if (S == nullptr) return;
+
+  // references to images within the declaration of accessors, iteration
+  // spaces, and boundary conditions are no host accesses
+  if (auto DS = dyn_cast<DeclStmt>(S)) {
+    for (auto decl : DS->decls()) {
+      if (auto VD = dyn_cast<VarDecl>(decl)) {
+        if (compilerClasses.isTypeOfTemplateClass(VD->getType(),
+              compilerClasses.Accessor) ||
+            compilerClasses.isTypeOfTemplateClass(VD->getType(),
+              compilerClasses.IterationSpace) ||
+            compilerClasses.isTypeOfTemplateClass(VD->getType(),
+              compilerClasses.BoundaryCondition))
+          continue;
+        trackHostUses(VD->getInit());
+      }
+    }
+    return;
+  }
+
+  if (auto DRE = dyn_cast<DeclRefExpr>(S)) {
+    if (imgDeclMap_.count(DRE->getDecl())) {
+      if (DEBUG) std::cout << "  Tracked host access to Image: "
+              << DRE->getNameInfo().getAsString() << std::endl;
+      dataDeps.addHostUse(DRE->getDecl(), DRE->getLocStart());
+    }
+  }
+
+  for (auto child : S->children())
+    trackHostUses(child);
+}
+
+
 void HostDataDeps::addImage(ValueDecl *VD, HipaccImage *img) {
   assert(!imgMap_.count(VD) && "Duplicate Image declaration");
   imgMap_[VD] = new Image(img);
@@ -338,12 +386,15 @@ void HostDataDeps::addBoundaryCondition(
 void HostDataDeps::addKernel(
     ValueDecl *KVD, ValueDecl *ISVD, std::vector<ValueDecl*> AVDS) {
   Kernel *kernel;
-  assert(iterMap_.count(ISVD) && "IterationSpace was not declared");
+  if (!iterMap_.count(ISVD)) {
+    setUnsupported("IterationSpace was not declared");
+    return;
+  }
   assert(!kernelMap_.count(KVD) && "Duplicate Kernel declaration");
   kernel = new Kernel(
       KVD->getType()->getAsCXXRecordDecl()->getNameAsString()
           .append(KVD->getNameAsString()),
-      iterMap_[ISVD]);
+      KVD, iterMap_[ISVD]);
   for (auto it = AVDS.begin(); it != AVDS.end(); ++it) {
     assert(accMap_.count(*it) && "Accessor was not declared");
     kernel->addAccessor(accMap_[*it]);
@@ -353,7 +404,7 @@ void HostDataDeps::addKernel(
 
 
 void HostDataDeps::addAccessor(
-    ValueDecl *AVD, HipaccAccessor *acc, ValueDecl* IVD) {
+    ValueDecl *AVD, HipaccAccessor *acc, ValueDecl* IVD, bool direct) {
   //assert(findMap(images_, image) && "Image was not declared");
   Image *img;
 
@@ -361,33 +412,45 @@ void HostDataDeps::addAccessor(
     img = imgMap_[IVD];
   } else {
     if (!bcMap_.count(IVD)) {
-      assert(false && "Image or BoundaryCondition was not declared");
+      setUnsupported("Image or BoundaryCondition was not declared");
+      return;
     } else {
       img = bcMap_[IVD]->getImage();
     }
   }
 
   assert(!accMap_.count(AVD) && "Duplicate Accessor declaration");
-  accMap_[AVD] = new Accessor(acc, img);
+  accMap_[AVD] = new Accessor(acc, img, direct);
 }
 
 
 void HostDataDeps::addIterationSpace(
-    ValueDecl *ISVD, HipaccIterationSpace *iter, ValueDecl *IVD) {
+    ValueDecl *ISVD, HipaccIterationSpace *iter, ValueDecl *IVD, bool direct) {
   assert(imgMap_.count(IVD) && "Image was not declared");
   assert(!iterMap_.count(ISVD) && "Duplicate IterationSpace declaration");
-  iterMap_[ISVD] = new IterationSpace(iter, imgMap_[IVD]);
+  iterMap_[ISVD] = new IterationSpace(iter, imgMap_[IVD], direct);
+}
+
+
+void HostDataDeps::addHostUse(ValueDecl *IVD, SourceLocation loc) {
+  if (imgMap_.count(IVD)) {
+    hostImages_.insert(imgMap_[IVD]);
+    hostUses_.push_back(std::make_pair(loc, imgMap_[IVD]));
+  }
 }
 
 
-void HostDataDeps::runKernel(ValueDecl *VD) {
-  assert(kernelMap_.count(VD) && "Kernel was not declared");
+void HostDataDeps::runKernel(ValueDecl *VD, SourceLocation loc) {
+  if (!kernelMap_.count(VD)) {
+    setUnsupported("Kernel was not declared");
+    return;
+  }
 
   Kernel *kernel = kernelMap_[VD];
 
   // Create new process and output space
   Space *space = new Space(kernel->getIterationSpace()->getImage());
-  Process *proc = new Process(kernel, space);
+  Process *proc = new Process(kernel, space, loc);
   space->setSrcProcess(proc);
   spaces_.push_back(space);
   processes_.push_back(proc);
@@ -589,6 +652,89 @@ void HostDataDeps::createSchedule() {
 }
 
 
+HostDataDeps::Process *HostDataDeps::getProcess(Kernel *kernel) {
+  Process *retVal = nullptr;
+  for (auto it = processes_.begin(); it != processes_.end(); ++it) {
+    if ((*it)->getKernel() == kernel) {
+      // kernels executed more than once are not unique
+      if (retVal != nullptr) return nullptr;
+      retVal = *it;
+    }
+  }
+  return retVal;
+}
+
+
+// kernel fusion is implemented for C/C++ code generation only: CUDA and
+// OpenCL kernels would have to recompute the producer for the halo of each
+// thread block and are not fused
+bool HostDataDeps::isFusible(Space *s) {
+  if (!supported) return false;
+
+  // computed by a single kernel and read by exactly one other kernel
+  Process *src = s->getSrcProcess();
+  std::vector<Process*> dst = s->getDstProcesses();
+  if (src == nullptr || dst.size() != 1 || dst[0] == src) return false;
+
+  // intermediate image is neither accessed by host code nor reused
+  Image *image = s->getImage();
+  if (hostImages_.count(image)) return false;
+  for (auto it = spaces_.begin(); it != spaces_.end(); ++it) {
+    if (*it != s && (*it)->getImage() == image) return false;
+  }
+
+  // both kernels are executed exactly once
+  if (getProcess(src->getKernel()) != src ||
+      getProcess(dst[0]->getKernel()) != dst[0]) return false;
+
+  // the producer is declared before its consumer, so that the consumer can be
+  // generated at its declaration
+  if (!(src->getKernel()->getDecl()->getLocation() <
+        dst[0]->getKernel()->getDecl()->getLocation())) return false;
+
+  // producer and consumer operate on the same pixel coordinates
+  if (!src->getKernel()->getIterationSpace()->isDirect()) return false;
+  std::vector<Accessor*> accs = dst[0]->getKernel()->getAccessors(image);
+  for (auto it = accs.begin(); it != accs.end(); ++it) {
+    if (!(*it)->isDirect()) return false;
+  }
+
+  // inputs of the producer are not overwritten until the consumer is executed
+  std::vector<Space*> inSpaces = src->getInSpaces();
+  for (auto it = inSpaces.begin(); it != inSpaces.end(); ++it) {
+    auto pos = std::find(spaces_.begin(), spaces_.end(), *it);
+    for (++pos; pos != spaces_.end(); ++pos) {
+      if ((*pos)->getImage() == (*it)->getImage()) return false;
+    }
+  }
+
+  // ... neither by host code between producer and consumer, e.g. by writing
+  // host memory to them or copying images
+  SourceLocation begin = src->getLocation(), end = dst[0]->getLocation();
+  for (auto use = hostUses_.begin(); use != hostUses_.end(); ++use) {
+    if (use->first < begin || !(use->first < end)) continue;
+    for (auto it = inSpaces.begin(); it != inSpaces.end(); ++it) {
+      if ((*it)->getImage() == use->second) return false;
+    }
+  }
+
+  return true;
+}
+
+
+void HostDataDeps::markFusion() {
+  for (auto it = spaces_.begin(); it != spaces_.end(); ++it) {
+    if (isFusible(*it)) {
+      if (DEBUG) std::cout << "  Fusing kernel "
+              << (*it)->getSrcProcess()->getKernel()->getName() << " into "
+              << (*it)->getDstProcesses()[0]->getKernel()->getName()
+              << std::endl;
+      fusedSpaces_.insert(*it);
+    }
+  }
+}
+
+
 std::string HostDataDeps::getEntrySignature(
     std::map<std::string,std::vector<std::pair<std::string,std::string>>> args,
     bool withTypes) {
@@ -956,6 +1102,33 @@ std::string HostDataDeps::getStreamDecl(ValueDecl *VD) {
 }
 
 
+bool HostDataDeps::isFusedKernel(ValueDecl *KVD) {
+  if (!kernelMap_.count(KVD)) return false;
+
+  Process *proc = getProcess(kernelMap_[KVD]);
+  return proc != nullptr && fusedSpaces_.count(proc->getOutSpace());
+}
+
+
+ValueDecl *HostDataDeps::getFusedKernel(ValueDecl *KVD, ValueDecl *AVD) {
+  if (!kernelMap_.count(KVD) || !accMap_.count(AVD)) return nullptr;
+
+  Process *proc = getProcess(kernelMap_[KVD]);
+  if (proc == nullptr) return nullptr;
+
+  Image *image = accMap_[AVD]->getImage();
+  std::vector<Space*> spaces = proc->getInSpaces();
+  for (auto it = spaces.begin(); it != spaces.end(); ++it) {
+    Space *s = *it;
+    if (s->getImage() == image && fusedSpaces_.count(s)) {
+      return s->getSrcProcess()->getKernel()->getDecl();
+    }
+  }
+
+  return nullptr;
+}
+
+
 const bool HostDataDeps::DEBUG =
 #ifdef PRINT_DEBUG
     true;
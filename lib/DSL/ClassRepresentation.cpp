@@ -462,9 +462,9 @@ void HipaccKernel::setDefaultConfig() {
 void HipaccKernel::addParam(QualType QT1, QualType QT2, QualType QT3,
     std::string typeC, std::string typeO, std::string name, FieldDecl *fd) {
   switch (options.getTargetLang()) {
-    case Language::Vivado:
-    case Language::C99:          argTypes.push_back(QT3);
+    case Language::Vivado:       argTypes.push_back(QT3);
                                  argTypeNames.push_back(typeC); break;
+    case Language::C99:
     case Language::CUDA:         argTypes.push_back(QT1);
                                  argTypeNames.push_back(typeC); break;
     case Language::OpenCLACC:
@@ -575,6 +575,33 @@ void HipaccKernel::createArgInfo() {
 }
 
 
+// arguments of the per-pixel function of a fused kernel: used arguments of the
+// kernel itself followed by those of the kernels fused into it
+void HipaccKernel::getFusedArgs(std::string prefix,
+    SmallVectorImpl<std::pair<QualType, std::string>> &args) {
+  createArgInfo();
+
+  for (size_t i=0; i<deviceArgNames.size(); ++i) {
+    if (!getUsed(deviceArgNames[i]))
+      continue;
+
+    QualType QT = argTypes[i];
+    if (FieldDecl *FD = deviceArgFields[i]) {
+      // constant masks are defined globally
+      if (getMaskFromMapping(FD))
+        continue;
+      // images are only read by fused kernels
+      if (getImgFromMapping(FD))
+        QT = Ctx.getPointerType(Ctx.getConstType(QT->getPointeeType()));
+    }
+    args.push_back(std::make_pair(QT, prefix + deviceArgNames[i]));
+  }
+
+  for (auto K : fusedKernels)
+    K->getFusedArgs(prefix + K->getName() + "_", args);
+}
+
+
 void HipaccKernel::createHostArgInfo(ArrayRef<Expr *> hostArgs, std::string
     &hostLiterals, unsigned &literalCount) {
   if (hostArgNames.size()) hostArgNames.clear();
@@ -227,8 +227,16 @@ void CreateHostStrings::writeMemoryAllocation(HipaccImage *Img, std::string
     width, std::string height, std::string host, std::string &resultStr) {
   resultStr += "HipaccImage " + Img->getName() + " = ";
   switch (options.getTargetLang()) {
-    case Language::Vivado:
     case Language::C99:
+      if (options.useCPUZeroCopy() && host != "NULL") {
+        // wrap host memory, no padding
+        resultStr += "hipaccCreateMemoryView<" + Img->getTypeStr() + ">(";
+        resultStr += host + ", " + width + ", " + height + ");";
+        return;
+      }
+      resultStr += "hipaccCreateMemory<" + Img->getTypeStr() + ">(";
+      break;
+    case Language::Vivado:
       resultStr += "hipaccCreateMemory<" + Img->getTypeStr() + ">(";
       break;
     case Language::CUDA:
@@ -741,15 +749,34 @@ void CreateHostStrings::writeKernelCall(HipaccKernel *K, bool isOutputProcess, s
         case Language::Vivado:
         case Language::C99:
           if (i==0) {
-            resultStr += "hipaccStartTiming();\n";
-            resultStr += indent;
+            if (options.emitC99() && K->isTask()) {
+              // launch as task: kernels on coarse pyramid levels may be
+              // deferred by the runtime and run concurrently
+              std::string reads, writes;
+              writeKernelImages(K, false, reads);
+              writeKernelImages(K, true, writes);
+              resultStr += "hipaccLaunchKernel({" + reads + "}, {" + writes;
+              resultStr += "}, " + K->getIterationSpace()->getName() +
+                           ".width*" + K->getIterationSpace()->getName() +
+                           ".height, " +
+                           std::to_string(options.getCPUThreads()) +
+                           ", [=] () {\n";
+              resultStr += indent + std::string(num_indent, ' ');
+            } else {
+              resultStr += "hipaccStartTiming();\n";
+              resultStr += indent;
+            }
             resultStr += kernel_name + "(";
           } else {
             resultStr += ", ";
           }
           if (Acc) {
             resultStr += "(" + Acc->getImage()->getTypeStr();
-            resultStr += "(*)[" + Acc->getImage()->getSizeXStr() + "])";
+            if (options.emitC99()) {
+              resultStr += "*)";
+            } else {
+              resultStr += "(*)[" + Acc->getImage()->getSizeXStr() + "])";
+            }
           }
           if (Mask) {
             resultStr += "(" + argTypeNames[i] + ")";
@@ -790,10 +817,16 @@ void CreateHostStrings::writeKernelCall(HipaccKernel *K, bool isOutputProcess, s
     }
   }
   if (options.getTargetLang()==Language::C99) {
+    // arguments of fused kernels
+    writeFusedKernelArgs(K, resultStr);
     // close parenthesis for function call
     resultStr += ");\n";
     resultStr += indent;
-    resultStr += "hipaccStopTiming();\n";
+    if (K->isTask()) {
+      resultStr += "});\n";
+    } else {
+      resultStr += "hipaccStopTiming();\n";
+    }
     resultStr += indent;
   }
   resultStr += "\n" + indent;
@@ -911,6 +944,64 @@ void CreateHostStrings::writeKernelCall(HipaccKernel *K, bool isOutputProcess, s
 }
 
 
+void CreateHostStrings::writeFusedKernelArgs(HipaccKernel *K, std::string
+    &resultStr) {
+  for (auto FK : K->getFusedKernels()) {
+    auto deviceArgNames = FK->getDeviceArgNames();
+    auto hostArgNames = FK->getHostArgNames();
+
+    size_t num_arg = 0;
+    for (auto arg : FK->getDeviceArgFields()) {
+      size_t i = num_arg++;
+
+      // skip unused variables and constant masks
+      if (!FK->getUsed(deviceArgNames[i]) || FK->getMaskFromMapping(arg))
+        continue;
+
+      resultStr += ", ";
+      if (auto Acc = FK->getImgFromMapping(arg)) {
+        resultStr += "(" + Acc->getImage()->getTypeStr() + "*)";
+        resultStr += hostArgNames[i] + "->mem";
+      } else {
+        resultStr += hostArgNames[i];
+      }
+    }
+
+    writeFusedKernelArgs(FK, resultStr);
+  }
+}
+
+
+void CreateHostStrings::writeKernelImages(HipaccKernel *K, bool write,
+    std::string &resultStr) {
+  auto deviceArgNames = K->getDeviceArgNames();
+  auto hostArgNames = K->getHostArgNames();
+
+  size_t num_arg = 0;
+  for (auto arg : K->getDeviceArgFields()) {
+    size_t i = num_arg++;
+
+    // skip unused variables
+    if (!K->getUsed(deviceArgNames[i]))
+      continue;
+
+    // the iteration space is written, all other images are read
+    HipaccAccessor *Acc = K->getImgFromMapping(arg);
+    if (!Acc || (Acc == K->getIterationSpace()) != write)
+      continue;
+
+    if (!resultStr.empty()) resultStr += ", ";
+    resultStr += hostArgNames[i] + "->mem";
+  }
+
+  // fused kernels only contribute images that are read
+  if (!write) {
+    for (auto FK : K->getFusedKernels())
+      writeKernelImages(FK, write, resultStr);
+  }
+}
+
+
 void CreateHostStrings::writeReduceCall(HipaccKernel *K, std::string &resultStr) {
   std::string typeStr(K->getIterationSpace()->getImage()->getTypeStr());
   std::string red_decl(typeStr + " " + K->getReduceStr() + " = ");
@@ -924,7 +1015,11 @@ void CreateHostStrings::writeReduceCall(HipaccKernel *K, std::string &resultStr)
       resultStr += red_decl;
       resultStr += K->getReduceName() + "2DKernel(";
       resultStr += "(" + K->getIterationSpace()->getImage()->getTypeStr();
-      resultStr += "(*)[" + K->getIterationSpace()->getImage()->getSizeXStr() + "])";
+      if (options.emitC99()) {
+        resultStr += "*)";
+      } else {
+        resultStr += "(*)[" + K->getIterationSpace()->getImage()->getSizeXStr() + "])";
+      }
       resultStr += K->getIterationSpace()->getName() + ".img->mem, ";
       resultStr += K->getIterationSpace()->getName() + ".width, ";
       resultStr += K->getIterationSpace()->getName() + ".height, ";
@@ -1056,8 +1151,7 @@ void CreateHostStrings::writeBinningCall(HipaccKernel *K, std::string &resultStr
       resultStr += indent;
       resultStr += bin_decl;
       resultStr += K->getBinningName() + "2DKernel(";
-      resultStr += "(" + K->getIterationSpace()->getImage()->getTypeStr();
-      resultStr += "(*)[" + K->getIterationSpace()->getImage()->getSizeXStr() + "])";
+      resultStr += "(" + K->getIterationSpace()->getImage()->getTypeStr() + "*)";
       resultStr += K->getIterationSpace()->getName() + ".img->mem, ";
       resultStr += K->getNumBinsStr() + ", ";
       resultStr += K->getIterationSpace()->getName() + ".width, ";
@@ -1123,14 +1217,22 @@ std::string CreateHostStrings::getInterpolationDefinition(HipaccKernel *K,
     HipaccAccessor *Acc, std::string function_name, std::string type_suffix,
     Interpolate ip_mode, Boundary bh_mode) {
   std::string str;
+  // bilinear interpolation of 8/16-bit integer images in fixed-point
+  // arithmetic, also for the variant without boundary handling
+  HipaccImage *Img = Acc->getImage();
+  std::string fixed;
+  if (Acc->getInterpolationMode() == Interpolate::LF &&
+      Img->getType()->isIntegerType() && Img->getPixelSize() <= 2)
+    fixed = "_FIXED";
   // interpolation macro
   switch (ip_mode) {
     case Interpolate::NO:
     case Interpolate::NN:
-      str += "DEFINE_BH_VARIANT_NO_BH(INTERPOLATE_LINEAR_FILTERING";
+    case Interpolate::RS:
+      str += "DEFINE_BH_VARIANT_NO_BH(INTERPOLATE_LINEAR_FILTERING" + fixed;
       break;
     case Interpolate::LF:
-      str += "DEFINE_BH_VARIANT(INTERPOLATE_LINEAR_FILTERING";
+      str += "DEFINE_BH_VARIANT(INTERPOLATE_LINEAR_FILTERING" + fixed;
       break;
     case Interpolate::CF:
       str += "DEFINE_BH_VARIANT(INTERPOLATE_CUBIC_FILTERING";
@@ -1140,8 +1242,8 @@ std::string CreateHostStrings::getInterpolationDefinition(HipaccKernel *K,
       break;
   }
   switch (options.getTargetLang()) {
-    case Language::Vivado:
-    case Language::C99:                              break;
+    case Language::Vivado:                           break;
+    case Language::C99:          str += "_CPU, ";    break;
     case Language::CUDA:         str += "_CUDA, ";   break;
     case Language::OpenCLACC:
     case Language::OpenCLCPU:
@@ -1207,10 +1309,14 @@ std::string CreateHostStrings::getInterpolationDefinition(HipaccKernel *K,
 
 
 void CreateHostStrings::writePyramidAllocation(std::string pyrName, std::string
-    type, std::string img, std::string depth, std::string &resultStr) {
+    type, std::string img, std::string depth, std::string temporary,
+    std::string &resultStr) {
   resultStr += "HipaccPyramid " + pyrName + " = ";
   resultStr += "hipaccCreatePyramid<" + type + ">(";
-  resultStr += img + ", " + depth + ");";
+  resultStr += img + ", " + depth;
+  if (!temporary.empty())
+    resultStr += ", " + temporary;
+  resultStr += ");";
 }
 
 // vim: set ts=2 sw=2 sts=2 et ai:
@@ -45,6 +45,7 @@
 #include "hipacc/Analysis/HostDataDeps.h"
 
 #include <clang/AST/ASTConsumer.h>
+#include <clang/AST/PrettyPrinter.h>
 #include <clang/AST/RecursiveASTVisitor.h>
 #include <clang/Rewrite/Core/Rewriter.h>
 #include <llvm/Support/Path.h>
@@ -66,6 +67,50 @@ using namespace ASTNode;
 
 
 namespace {
+// print loop hints of C/C++ kernels per compiler: Clang loop hints for Clang,
+// OpenMP simd for other compilers in case memory dependencies are ignored
+class LoopHintPrinter : public PrinterHelper {
+  private:
+    PrintingPolicy &Policy;
+
+  public:
+    explicit LoopHintPrinter(PrintingPolicy &Policy) : Policy(Policy) {}
+
+    bool handledStmt(Stmt *S, raw_ostream &OS) override {
+      auto AS = dyn_cast<AttributedStmt>(S);
+      if (!AS || !hasSpecificAttr<LoopHintAttr>(AS->getAttrs()))
+        return false;
+
+      bool simd = false;
+      std::string simdlen;
+      OS << "#ifdef __clang__\n";
+      for (auto attr : AS->getAttrs()) {
+        auto LH = dyn_cast<LoopHintAttr>(attr);
+        if (!LH)
+          continue;
+        LH->printPretty(OS, Policy);
+        if (LH->getOption() == LoopHintAttr::Vectorize &&
+            LH->getState() == LoopHintAttr::AssumeSafety)
+          simd = true;
+        if (LH->getOption() == LoopHintAttr::VectorizeWidth) {
+          llvm::raw_string_ostream SS(simdlen);
+          LH->getValue()->printPretty(SS, nullptr, Policy);
+        }
+      }
+      if (simd) {
+        OS << "#else\n#pragma omp simd";
+        if (!simdlen.empty())
+          OS << " simdlen(" << simdlen << ")";
+        OS << "\n";
+      }
+      OS << "#endif\n";
+      AS->getSubStmt()->printPretty(OS, this, Policy, 2);
+
+      return true;
+    }
+};
+
+
 class Rewrite : public ASTConsumer,  public RecursiveASTVisitor<Rewrite> {
   private:
     // Clang internals
@@ -107,6 +152,8 @@ class Rewrite : public ASTConsumer,  public RecursiveASTVisitor<Rewrite> {
     FileID mainFileID;
     unsigned literalCount;
     bool skipTransfer;
+    bool useIntegralImage;
+    bool useRecursiveFilter;
 
   public:
     Rewrite(CompilerInstance &CI, CompilerOptions &options,
@@ -125,7 +172,9 @@ class Rewrite : public ASTConsumer,  public RecursiveASTVisitor<Rewrite> {
       compilerClasses(CompilerKnownClasses()),
       mainFD(nullptr),
       literalCount(0),
-      skipTransfer(false)
+      skipTransfer(false),
+      useIntegralImage(false),
+      useRecursiveFilter(false)
     {}
 
     // RecursiveASTVisitor
@@ -272,6 +321,10 @@ class Rewrite : public ASTConsumer,  public RecursiveASTVisitor<Rewrite> {
     }
 
     void setKernelConfiguration(HipaccKernelClass *KC, HipaccKernel *K);
+    void checkGlobalOperator(CallExpr *E, std::string name);
+    HipaccImage *getGlobalOperatorImage(CallExpr *E, unsigned num);
+    void rewriteIntegralImage(CallExpr *E);
+    void rewriteRecursiveFilter(CallExpr *E);
     void printBinningFunction(HipaccKernelClass *KC, HipaccKernel *K,
         llvm::raw_fd_ostream &OS);
     void printReductionFunction(HipaccKernelClass *KC, HipaccKernel *K,
@@ -300,6 +353,8 @@ class Rewrite : public ASTConsumer,  public RecursiveASTVisitor<Rewrite> {
     void printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
         HipaccKernel *K, PrintingPolicy &Policy, llvm::raw_ostream &OS,
         PrintParam=None);
+    void getKernelCallArguments(FunctionDecl *D, HipaccKernel *K,
+        SmallVectorImpl<std::string> &args);
     std::map<std::string,std::vector<std::pair<std::string, std::string>>> entryArguments;
     std::string vivadoSizeX = "1";
     std::string vivadoSizeY = "1";
@@ -426,9 +481,14 @@ void Rewrite::HandleTranslationUnit(ASTContext &) {
   // get include header string, including a header twice is fine
   stringCreator.writeHeaders(newStr);
 
-  // add interpolation include and define interpolation functions for CUDA
-  if (compilerOptions.emitCUDA() && InterpolationDefinitionsGlobal.size()) {
-    newStr += "#include \"hipacc_cu_interpolate.hpp\"\n";
+  // add interpolation include and define interpolation functions for CUDA and
+  // C/C++ (kernel files are included by the host file)
+  if ((compilerOptions.emitCUDA() || compilerOptions.emitC99()) &&
+      InterpolationDefinitionsGlobal.size()) {
+    if (compilerOptions.emitC99())
+      newStr += "#include \"hipacc_cpu_interpolate.hpp\"\n";
+    else
+      newStr += "#include \"hipacc_cu_interpolate.hpp\"\n";
 
     // sort definitions and remove duplicate definitions
     std::sort(InterpolationDefinitionsGlobal.begin(),
@@ -444,6 +504,28 @@ void Rewrite::HandleTranslationUnit(ASTContext &) {
     newStr += "\n";
   }
 
+  // add scan include for integral images
+  if (useIntegralImage) {
+    if (compilerOptions.emitC99())
+      newStr += "#include \"hipacc_cpu_scan.hpp\"\n";
+    if (compilerOptions.emitCUDA())
+      newStr += "#include \"hipacc_cu_scan.hpp\"\n";
+    if (compilerOptions.emitOpenCL())
+      newStr += "#include \"hipacc_cl_scan.hpp\"\n";
+    newStr += "\n";
+  }
+
+  // add recursive filter include
+  if (useRecursiveFilter) {
+    if (compilerOptions.emitC99())
+      newStr += "#include \"hipacc_cpu_recursive.hpp\"\n";
+    if (compilerOptions.emitCUDA())
+      newStr += "#include \"hipacc_cu_recursive.hpp\"\n";
+    if (compilerOptions.emitOpenCL())
+      newStr += "#include \"hipacc_cl_recursive.hpp\"\n";
+    newStr += "\n";
+  }
+
   // include .cu or .h files for normal kernels
   switch (compilerOptions.getTargetLang()) {
     default: break;
@@ -822,11 +904,10 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
         std::string width_str  = convertToString(CCE->getArg(0));
         std::string height_str = convertToString(CCE->getArg(1));
 
-        if (compilerOptions.emitC99() || compilerOptions.emitVivado() 
-                                      || compilerOptions.emitOpenCLFPGA()) {
+        if (compilerOptions.emitVivado() || compilerOptions.emitOpenCLFPGA()) {
           // check if the parameter can be resolved to a constant
           unsigned IDConstant = Diags.getCustomDiagID(DiagnosticsEngine::Error,
-                "Constant expression for %0 argument of Image %1 required (C/C++ only).");
+                "Constant expression for %0 argument of Image %1 required (Vivado/OpenCL FPGA only).");
           if (!CCE->getArg(0)->isEvaluatable(Context)) {
             Diags.Report(CCE->getArg(0)->getExprLoc(), IDConstant) << "width"
               << Img->getName();
@@ -835,14 +916,34 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
             Diags.Report(CCE->getArg(1)->getExprLoc(), IDConstant) << "height"
               << Img->getName();
           }
+        }
 
+        // C/C++ kernels get the image size at run-time, constant sizes are
+        // only used to emit specialized kernels
+        if ((compilerOptions.emitC99() &&
+             CCE->getArg(0)->isEvaluatable(Context) &&
+             CCE->getArg(1)->isEvaluatable(Context)) ||
+            compilerOptions.emitVivado() || compilerOptions.emitOpenCLFPGA()) {
           int64_t img_stride = CCE->getArg(0)->EvaluateKnownConstInt(Context).getSExtValue();
           int64_t img_height = CCE->getArg(1)->EvaluateKnownConstInt(Context).getSExtValue();
 
           if ((int)maxImageWidth < img_stride) maxImageWidth = img_stride;
           if ((int)maxImageHeight < img_height) maxImageHeight = img_height;
 
-          if (compilerOptions.emitPadding()) {
+          if (compilerOptions.emitC99()) {
+            // mirror hipaccAlignedStride() of the CPU runtime
+            if (compilerOptions.emitPadding() &&
+                !(compilerOptions.useCPUZeroCopy() && CCE->getNumArgs() == 3)) {
+              int64_t pixel_size = Context.getTypeSize(Img->getType())/8;
+              int64_t alignment = (targetDevice.alignment + pixel_size - 1)
+                                    / pixel_size * pixel_size;
+              int64_t align_px = alignment / pixel_size;
+              img_stride = ((img_stride+align_px-1) / align_px) * align_px;
+
+              if ((img_stride * pixel_size) % 4096 == 0)
+                img_stride += align_px;
+            }
+          } else if (compilerOptions.emitPadding()) {
             // respect alignment/padding for constantly sized CPU images
             int64_t alignment = compilerOptions.getAlignment()
                                   / (Context.getTypeSize(Img->getType())/8);
@@ -952,8 +1053,8 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
       if (compilerClasses.isTypeOfTemplateClass(VD->getType(),
             compilerClasses.Pyramid)) {
         CXXConstructExpr *CCE = dyn_cast<CXXConstructExpr>(VD->getInit());
-        assert(CCE->getNumArgs() == 2 &&
-               "Pyramid definition requires exactly two arguments!");
+        assert(CCE->getNumArgs() == 3 &&
+               "Pyramid definition requires exactly three arguments!");
 
         HipaccPyramid *Pyr = new HipaccPyramid(Context, VD,
             compilerClasses.getFirstTemplateType(VD->getType()));
@@ -961,12 +1062,15 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
         // get the text string for the pyramid image & depth
         std::string image_str = convertToString(CCE->getArg(0));
         std::string depth_str = convertToString(CCE->getArg(1));
+        std::string temporary_str;
+        if (!isa<CXXDefaultArgExpr>(CCE->getArg(2)))
+          temporary_str = convertToString(CCE->getArg(2));
 
         // create memory allocation string
         std::string newStr;
         stringCreator.writePyramidAllocation(VD->getName(),
             compilerClasses.getFirstTemplateType(VD->getType()).getAsString(),
-            image_str, depth_str, newStr);
+            image_str, depth_str, temporary_str, newStr);
 
         // rewrite Pyramid definition
         // get the start location and compute the semi location.
@@ -1182,6 +1286,16 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
         assert(BC && "Expected BoundaryCondition, Image or Pyramid call as "
                      "first argument to Accessor.");
 
+        // streaming windows are read at the iteration space resolution
+        if (mode == Interpolate::RS && (compilerOptions.emitVivado() ||
+              compilerOptions.emitOpenCLFPGA())) {
+          unsigned DiagIDResample =
+              Diags.getCustomDiagID(DiagnosticsEngine::Error,
+                  "Resampling Accessor %0 is not supported for FPGA targets.");
+          Diags.Report(VD->getLocation(), DiagIDResample) << VD->getName();
+          exit(EXIT_FAILURE);
+        }
+
         Acc = new HipaccAccessor(VD, BC, mode, roi_args == 4);
 
         std::string newStr;
@@ -1539,6 +1653,30 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
           // set kernel configuration
           setKernelConfiguration(KC, K);
 
+          // kernel fusion for C/C++: producers are computed per pixel within
+          // their consumer, which has to be declared after the producer
+          if (compilerOptions.emitC99() && compilerOptions.fuseKernels()) {
+            if (dataDeps->isFusedKernel(VD) && !KC->getReduceFunction() &&
+                !KC->getBinningFunction() &&
+                !(KC->getMemPattern(KC->getOutField()) & USER_XY)) {
+              bool fusible = true;
+              for (auto mask : KC->getMaskFields())
+                fusible &= K->getMaskFromMapping(mask)->isConstant();
+              if (fusible)
+                K->setFused();
+            }
+
+            for (auto img : KC->getImgFields()) {
+              if (img == KC->getOutField())
+                continue;
+              HipaccAccessor *Acc = K->getImgFromMapping(img);
+              ValueDecl *PVD = dataDeps->getFusedKernel(VD, Acc->getDecl());
+              if (PVD && KernelDeclMap.count(PVD) &&
+                  KernelDeclMap[PVD]->isFused())
+                K->addFusedKernel(Acc, KernelDeclMap[PVD]);
+            }
+          }
+
           // kernel declaration
           FunctionDecl *kernelDecl = createFunctionDecl(Context,
               Context.getTranslationUnitDecl(), K->getKernelName(),
@@ -1549,7 +1687,8 @@ bool Rewrite::VisitDeclStmt(DeclStmt *D) {
           // replacing member variables
           ASTTranslate *Hipacc = new ASTTranslate(Context, kernelDecl, K, KC,
               builtins, compilerOptions, compilerClasses);
-          if (compilerOptions.emitOpenCLFPGA()) {
+          if (compilerOptions.emitOpenCLFPGA() ||
+              compilerOptions.emitVivado()) {
             Hipacc->setBWMap(bwMap);
           }
           Stmt *kernelStmts =
@@ -1654,7 +1793,8 @@ bool Rewrite::VisitFunctionDecl(FunctionDecl *D) {
     assert(isa<CompoundStmt>(D->getBody()) && "CompoundStmt for main body expected.");
     mainFD = D;
 
-    if (compilerOptions.emitVivado() || compilerOptions.emitOpenCLFPGA()) {
+    if (compilerOptions.emitVivado() || compilerOptions.emitOpenCLFPGA() ||
+        (compilerOptions.emitC99() && compilerOptions.fuseKernels())) {
       AnalysisDeclContext AC(0, mainFD);
       dataDeps = HostDataDeps::parse(Context, AC, compilerClasses,
           compilerOptions);
@@ -1990,8 +2130,16 @@ bool Rewrite::VisitCXXMemberCallExpr(CXXMemberCallExpr *E) {
         //
         // TODO: handle the case when only reduce function is specified
         //
-        // create kernel call string
-        stringCreator.writeKernelCall(K, isOutputProcess, newStr);
+        // create kernel call string; fused kernels are computed within their
+        // consumer and only keep the temporaries for literals and invalidate
+        // their line buffers
+        if (K->isFused()) {
+          newStr += K->getEpochName() + "++;";
+        } else {
+          if (K->isLineBuffered())
+            newStr += K->getEpochName() + "++;\n" + stringCreator.getIndent();
+          stringCreator.writeKernelCall(K, isOutputProcess, newStr);
+        }
 
         // rewrite kernel invocation
         // get the start location and compute the semi location.
@@ -2139,12 +2287,110 @@ bool Rewrite::VisitCallExpr (CallExpr *E) {
         const char *semiPtr = strchr(startBuf, '(');
         TextRewriter.ReplaceText(startLoc, semiPtr-startBuf, "hipaccTraverse");
       }
+
+      // rewrite function calls 'integral_image' to 'hipaccIntegralImage'
+      if (DRE->getDecl()->getNameAsString() == "integral_image")
+        rewriteIntegralImage(E);
+
+      // rewrite function calls 'recursive_filter' to 'hipaccRecursiveFilter'
+      if (DRE->getDecl()->getNameAsString() == "recursive_filter")
+        rewriteRecursiveFilter(E);
     }
   }
   return true;
 }
 
 
+// global operators are implemented by the runtime for global memory images
+void Rewrite::checkGlobalOperator(CallExpr *E, std::string name) {
+  unsigned IDTarget = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+      "%0 is not supported for the selected target language.");
+  unsigned IDTexture = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+      "%0 requires images in global memory, Array2D textures are not "
+      "supported.");
+
+  switch (compilerOptions.getTargetLang()) {
+    case Language::C99:
+    case Language::CUDA:
+    case Language::OpenCLACC:
+    case Language::OpenCLCPU:
+    case Language::OpenCLGPU:
+      break;
+    default:
+      Diags.Report(E->getExprLoc(), IDTarget) << name;
+      exit(EXIT_FAILURE);
+  }
+
+  if (compilerOptions.useTextureMemory() &&
+      compilerOptions.getTextureType() == Texture::Array2D) {
+    Diags.Report(E->getExprLoc(), IDTexture) << name;
+    exit(EXIT_FAILURE);
+  }
+}
+
+
+HipaccImage *Rewrite::getGlobalOperatorImage(CallExpr *E, unsigned num) {
+  unsigned IDImage = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+      "Image object required as %ordinal0 argument.");
+
+  auto DRE = dyn_cast<DeclRefExpr>(E->getArg(num)->IgnoreParenImpCasts());
+  if (!DRE || !ImgDeclMap.count(DRE->getDecl())) {
+    Diags.Report(E->getArg(num)->getExprLoc(), IDImage) << num+1;
+    exit(EXIT_FAILURE);
+  }
+
+  return ImgDeclMap[DRE->getDecl()];
+}
+
+
+void Rewrite::rewriteIntegralImage(CallExpr *E) {
+  unsigned IDMode = Diags.getCustomDiagID(DiagnosticsEngine::Error,
+      "Integral images support only Reduce::SUM, Reduce::MIN, and "
+      "Reduce::MAX as mode.");
+
+  checkGlobalOperator(E, "Integral image");
+  HipaccImage *Img[2] = { getGlobalOperatorImage(E, 0),
+                          getGlobalOperatorImage(E, 1) };
+
+  std::string mode;
+  auto lval = E->getArg(2)->EvaluateKnownConstInt(Context);
+  switch (static_cast<Reduce>(lval.getZExtValue())) {
+    case Reduce::SUM: mode = "ScanSum"; break;
+    case Reduce::MIN: mode = "ScanMin"; break;
+    case Reduce::MAX: mode = "ScanMax"; break;
+    default:
+      Diags.Report(E->getArg(2)->getExprLoc(), IDMode);
+      exit(EXIT_FAILURE);
+  }
+
+  std::string newStr("hipaccIntegralImage<" + Img[1]->getTypeStr() + ", " +
+      Img[0]->getTypeStr() + ">(" + Img[0]->getName() + ", " +
+      Img[1]->getName() + ", " + mode + ")");
+  TextRewriter.ReplaceText(E->getSourceRange(), newStr);
+  useIntegralImage = true;
+}
+
+
+void Rewrite::rewriteRecursiveFilter(CallExpr *E) {
+  checkGlobalOperator(E, "Recursive filter");
+  HipaccImage *In = getGlobalOperatorImage(E, 0);
+  HipaccImage *Out = getGlobalOperatorImage(E, 1);
+
+  std::string mode;
+  auto lval = E->getArg(3)->EvaluateKnownConstInt(Context);
+  switch (static_cast<Recursive>(lval.getZExtValue())) {
+    case Recursive::GAUSSIAN:    mode = "RecursiveGaussian"; break;
+    case Recursive::EXPONENTIAL: mode = "RecursiveExponential"; break;
+  }
+
+  std::string newStr("hipaccRecursiveFilter<" + In->getTypeStr() + ">(" +
+      In->getName() + ", " + Out->getName() + ", " +
+      convertToString(E->getArg(2)) + ", " + mode + ")");
+  TextRewriter.ReplaceText(E->getSourceRange(), newStr);
+  useRecursiveFilter = true;
+}
+
+
 void Rewrite::setKernelConfiguration(HipaccKernelClass *KC, HipaccKernel *K) {
   #ifdef USE_JIT_ESTIMATE
   switch (compilerOptions.getTargetLang()) {
@@ -2341,10 +2587,7 @@ void Rewrite::printBinningFunction(HipaccKernelClass *KC, HipaccKernel *K,
          << pixelType.getAsString() << ", "
          << binType.getAsString() << ", "
          << K->getReduceName() << ", "
-         << K->getBinningName() << ", "
-         << K->getIterationSpace()->getImage()->getSizeXStr() << ", "
-         << K->getIterationSpace()->getImage()->getSizeYStr() << ", "
-         << KID << "PPT"
+         << K->getBinningName()
          << ")\n\n";
       break;
     case Language::CUDA: {
@@ -2447,6 +2690,11 @@ void Rewrite::printReductionFunction(HipaccKernelClass *KC, HipaccKernel *K,
       OS << "#include \"hipacc_vivado_red.hpp\"\n\n";
       break;
     case Language::C99:
+      if (compilerOptions.useCPUThreads()) {
+        OS << "#ifdef _OPENMP\n"
+           << "#define USE_OPENMP\n"
+           << "#endif\n";
+      }
       OS << "#include \"hipacc_cpu_red.hpp\"\n\n";
       break;
     case Language::OpenCLACC:
@@ -2547,10 +2795,7 @@ void Rewrite::printReductionFunction(HipaccKernelClass *KC, HipaccKernel *K,
       // 2D reduction
       OS << "REDUCTION_CPU_2D(" << K->getReduceName() << "2D, "
          << fun->getReturnType().getAsString() << ", "
-         << K->getReduceName() << ", "
-         << K->getIterationSpace()->getImage()->getSizeXStr() << ", "
-         << K->getIterationSpace()->getImage()->getSizeYStr() << ", "
-         << "PPT)\n";
+         << K->getReduceName() << ")\n";
       break;
     case Language::OpenCLACC:
     case Language::OpenCLCPU:
@@ -2664,6 +2909,13 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
       break;
     case Language::Vivado:
       break;
+    case Language::C99:
+      // per-pixel functions of fused kernels
+      for (auto FK : K->getFusedKernels())
+        OS << "#include \"" << FK->getFileName() << ".cc\"\n";
+      if (K->getFusedKernels().size())
+        OS << "\n";
+      break;
   }
 
   // declarations of textures, surfaces, variables, includes, definitions etc.
@@ -2711,7 +2963,7 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
           break;
       }
 
-      if (Acc->getInterpolationMode() > Interpolate::NN) {
+      if (Acc->getInterpolationMode() > Interpolate::RS) {
         switch (compilerOptions.getTargetLang()) {
           case Language::Vivado:
           case Language::C99: break;
@@ -2750,8 +3002,12 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
                    InterpolationDefinitionsLocal.push_back(no_bh_def);
                    InterpolationDefinitionsLocal.push_back(vec_conv);
                    break;
-          case Language::Vivado:
-          case Language::C99: break;
+          case Language::C99:
+                   InterpolationDefinitionsGlobal.push_back(bh_def);
+                   InterpolationDefinitionsGlobal.push_back(no_bh_def);
+                   InterpolationDefinitionsGlobal.push_back(vec_conv);
+                   break;
+          case Language::Vivado: break;
         }
       }
       continue;
@@ -2857,6 +3113,10 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
   if (compilerOptions.emitCUDA())
     OS << "extern \"C\" {\n";
 
+  // C/C++: execution counter of the kernel, invalidates its line buffers
+  if (K->isFused() || K->isLineBuffered())
+    OS << "static unsigned " << K->getEpochName() << " = 0;\n\n";
+
   // function definitions
   for (auto fun : K->getFunctionCalls()) {
     switch (compilerOptions.getTargetLang()) {
@@ -2935,25 +3195,149 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
          << " __attribute__((kernel)) ";
       break;
   }
-  if (!compilerOptions.emitFilterscript() &&
+
+  // C/C++ kernels index images using run-time strides; in case image sizes
+  // are known at compile time, emit a specialization using constant strides
+  std::vector<std::pair<std::string, unsigned>> strideSpecs;
+  if (compilerOptions.emitC99() && !K->isFused()) {
+    for (auto img : KC->getImgFields()) {
+      HipaccAccessor *Acc = K->getImgFromMapping(img);
+      std::string strideName = Acc->getStrideDecl()->getNameInfo().getAsString();
+      if (!Acc->getImage()->getSizeX() || !K->getUsed(strideName))
+        continue;
+      bool found = false;
+      for (auto spec : strideSpecs)
+        found |= spec.first == strideName;
+      if (!found)
+        strideSpecs.push_back(std::make_pair(strideName,
+              Acc->getImage()->getSizeX()));
+    }
+  }
+
+  if (K->isFused()) {
+    // C/C++: per-pixel function returning the output value at gid_x, gid_y
+    SmallVector<std::pair<QualType, std::string>, 16> fusedArgs;
+    K->getFusedArgs("", fusedArgs);
+    OS << "static inline " << K->getIterationSpace()->getImage()->getTypeStr()
+       << " " << K->getPixelName() << "(";
+    for (auto arg : fusedArgs) {
+      std::string Name(arg.second);
+      arg.first.getAsStringInternal(Name, Policy);
+      OS << Name << ", ";
+    }
+    OS << "int gid_x, int gid_y) ";
+  } else if (!compilerOptions.emitFilterscript() &&
       !compilerOptions.emitVivado() &&
       !compilerOptions.emitOpenCLFPGA()) {
+    if (strideSpecs.size())
+      OS << "static inline ";
     OS << "void ";
   }
 
-  if (!compilerOptions.emitVivado() && !compilerOptions.emitOpenCLFPGA()) {
+  if (!compilerOptions.emitVivado() && !compilerOptions.emitOpenCLFPGA() &&
+      !K->isFused()) {
     OS << K->getKernelName();
+    if (strideSpecs.size())
+      OS << "Impl";
     OS << "(";
     printKernelArguments(D, KC, K, Policy, OS);
     OS << ") ";
   }
 
   // print kernel body
-  D->getBody()->printPretty(OS, 0, Policy, 0);
+  LoopHintPrinter hintPrinter(Policy);
+  if (compilerOptions.emitC99() && compilerOptions.useCPUThreads() &&
+      !K->isFused()) {
+    // distribute the rows of the iteration space in bands across threads
+    OS << "{\n";
+    for (auto stmt : cast<CompoundStmt>(D->getBody())->body()) {
+      if (isa<ForStmt>(stmt)) {
+        // tasks pass the number of threads to the runtime, which runs
+        // deferred tasks on a single thread each
+        OS << "#pragma omp parallel for schedule(static)";
+        if (compilerOptions.getCPUThreads() && !K->isTask())
+          OS << " num_threads(" << compilerOptions.getCPUThreads() << ")";
+        OS << "\n";
+      }
+      stmt->printPretty(OS, &hintPrinter, Policy, 1);
+    }
+    OS << "}\n";
+  } else {
+    D->getBody()->printPretty(OS, &hintPrinter, Policy, 0);
+  }
   if (compilerOptions.emitCUDA()) {
     OS << "}\n";
   }
 
+  // print C/C++ function computing rows of fused kernels into a line buffer
+  // local to each thread; bands of rows processed by different threads
+  // recompute the rows overlapping the window
+  if (K->isFused()) {
+    SmallVector<std::pair<QualType, std::string>, 16> fusedArgs;
+    K->getFusedArgs("", fusedArgs);
+    std::string type(K->getIterationSpace()->getImage()->getTypeStr());
+    std::string width(K->getIterationSpace()->getWidthDecl()->getNameInfo()
+        .getAsString());
+    std::string args;
+
+    OS << "\nstatic inline " << type << " " << K->getLineName() << "(";
+    for (auto arg : fusedArgs) {
+      std::string Name(arg.second);
+      args += Name + ", ";
+      arg.first.getAsStringInternal(Name, Policy);
+      OS << Name << ", ";
+    }
+    OS << "int _rows, int gid_x, int gid_y) {\n"
+       << "  static thread_local HipaccLineBuffer<" << type << " > _buffer;\n"
+       << "  bool _fill;\n"
+       << "  " << type << " *_row = _buffer.getRow(gid_y, " << width
+       << ", _rows, " << K->getEpochName() << ", _fill);\n"
+       << "  if (_fill) {\n"
+       << "    for (int _x = 0; _x < " << width << "; ++_x)\n"
+       << "      _row[_x] = " << K->getPixelName() << "(" << args
+       << "_x, gid_y);\n"
+       << "  }\n"
+       << "  return _row[gid_x];\n"
+       << "}\n";
+  }
+
+  // print C/C++ entry function dispatching to the specialization
+  if (strideSpecs.size()) {
+    SmallVector<std::string, 16> argList;
+    getKernelCallArguments(D, K, argList);
+
+    // replace stride arguments by their constant value
+    std::string args, specArgs, cond;
+    for (auto arg : argList) {
+      std::string specArg = arg;
+      for (auto spec : strideSpecs) {
+        if (arg == spec.first)
+          specArg = std::to_string(spec.second);
+      }
+      if (args.size()) {
+        args += ", ";
+        specArgs += ", ";
+      }
+      args += arg;
+      specArgs += specArg;
+    }
+    for (auto spec : strideSpecs) {
+      if (cond.size())
+        cond += " && ";
+      cond += spec.first + " == " + std::to_string(spec.second);
+    }
+
+    OS << "\nvoid " << K->getKernelName() << "(";
+    printKernelArguments(D, KC, K, Policy, OS);
+    OS << ") {\n"
+       << "  if (" << cond << ") {\n"
+       << "    " << K->getKernelName() << "Impl(" << specArgs << ");\n"
+       << "  } else {\n"
+       << "    " << K->getKernelName() << "Impl(" << args << ");\n"
+       << "  }\n"
+       << "}\n";
+  }
+
   // print vivado entry function
   if (compilerOptions.emitVivado()) {
     OS << "};\n\n";
@@ -3158,6 +3542,37 @@ void Rewrite::printKernelFunction(FunctionDecl *D, HipaccKernelClass *KC,
 }
 
 
+// arguments of a C/C++ kernel call in the order of the kernel parameters, as
+// printed by printKernelArguments() for Rewrite::KernelCall
+void Rewrite::getKernelCallArguments(FunctionDecl *D, HipaccKernel *K,
+    SmallVectorImpl<std::string> &args) {
+  assert(compilerOptions.emitC99() && "C/C++ kernel calls only");
+
+  for (size_t i=0; i<D->getNumParams(); ++i) {
+    std::string Name(D->getParamDecl(i)->getNameAsString());
+    if (!K->getUsed(Name))
+      continue;
+
+    // constant Masks/Domains are declared in the kernel
+    FieldDecl *FD = K->getDeviceArgFields()[i];
+    if (auto Mask = K->getMaskFromMapping(FD)) {
+      if (Mask->isConstant())
+        continue;
+      Name = Mask->getName() + K->getName();
+    }
+    args.push_back(Name);
+  }
+
+  // arguments of fused kernels
+  for (auto FK : K->getFusedKernels()) {
+    SmallVector<std::pair<QualType, std::string>, 16> fusedArgs;
+    FK->getFusedArgs(FK->getName() + "_", fusedArgs);
+    for (auto arg : fusedArgs)
+      args.push_back(arg.second);
+  }
+}
+
+
 void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
     HipaccKernel *K, PrintingPolicy &Policy, llvm::raw_ostream &OS,
     enum Rewrite::PrintParam printParam) {
@@ -3227,6 +3642,10 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
         case Language::C99:
           if (comma++)
             OS << ", ";
+          if (printParam == Rewrite::PrintParam::KernelCall) {
+            OS << Mask->getName() << K->getName();
+            break;
+          }
           OS << "const "
              << Mask->getTypeStr()
              << " " << Mask->getName() << K->getName()
@@ -3264,14 +3683,14 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
         case Language::C99:
           if (comma++)
             OS << ", ";
+          if (printParam == Rewrite::PrintParam::KernelCall) {
+            OS << Name;
+            break;
+          }
           if (mem_acc == READ_ONLY)
             OS << "const ";
           OS << Acc->getImage()->getTypeStr()
-             << " " << Name
-             << "[" << Acc->getImage()->getSizeYStr() << "]"
-             << "[" << Acc->getImage()->getSizeXStr() << "]";
-          // alternative for Pencil:
-          // OS << "[static const restrict 2048][4096]";
+             << " * __restrict__ " << Name;
           break;
         case Language::CUDA:
           if (K->useTextureMemory(Acc) != Texture::None &&
@@ -3447,6 +3866,10 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
       // normal arguments
       if (comma++)
         OS << ", ";
+      if (printParam == Rewrite::PrintParam::KernelCall) {
+        OS << Name;
+        continue;
+      }
       T.getAsStringInternal(Name, Policy);
       OS << Name;
     }
@@ -3484,6 +3907,22 @@ void Rewrite::printKernelArguments(FunctionDecl *D, HipaccKernelClass *KC,
         break;
     }
   }
+
+  // C/C++: arguments of fused kernels
+  if (compilerOptions.emitC99()) {
+    for (auto FK : K->getFusedKernels()) {
+      SmallVector<std::pair<QualType, std::string>, 16> fusedArgs;
+      FK->getFusedArgs(FK->getName() + "_", fusedArgs);
+      for (auto arg : fusedArgs) {
+        std::string Name(arg.second);
+        if (comma++)
+          OS << ", ";
+        if (printParam != Rewrite::PrintParam::KernelCall)
+          arg.first.getAsStringInternal(Name, Policy);
+        OS << Name;
+      }
+    }
+  }
 }
 
 // vim: set ts=2 sw=2 sts=2 et ai:
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -58,6 +59,27 @@ enum hipaccMemoryType {
     Surface
 };
 
+// combine operation of 2D inclusive scans (integral images)
+enum hipaccScanMode {
+    ScanSum,
+    ScanMin,
+    ScanMax
+};
+
+// impulse response of recursive (IIR) filters
+enum hipaccRecursiveMode {
+    RecursiveGaussian,
+    RecursiveExponential
+};
+
+// feedback coefficients of recursive filters, applied causal and anti-causal:
+// y[n] = b*x[n] + a1*y[n-1] + a2*y[n-2] + a3*y[n-3]
+typedef struct hipacc_recursive_coeffs {
+    float b, a1, a2, a3;
+} hipacc_recursive_coeffs;
+
+hipacc_recursive_coeffs hipaccGetRecursiveCoeffs(float sigma, hipaccRecursiveMode mode);
+
 class HipaccImageBase {
     public:
         size_t width, height;
@@ -70,7 +92,7 @@ class HipaccImageBase {
     public:
         HipaccImageBase(size_t width, size_t height, size_t stride,
                     size_t alignment, size_t pixel_size, void *mem,
-                    hipaccMemoryType mem_type=Global);
+                    hipaccMemoryType mem_type=Global, bool alloc_host=true);
 
         ~HipaccImageBase();
 
@@ -160,13 +182,21 @@ void hipaccTraverse(unsigned int loop=1,
 
 
 // templates
+// levels of temporary pyramids may share memory with levels two or more
+// stages apart, i.e. only adjacent levels are guaranteed to be preserved; the
+// base image is never shared, so the saving is limited to levels 3 and deeper
 template<typename data_t>
-HipaccPyramid hipaccCreatePyramid(const HipaccImage &img, size_t depth);
+HipaccPyramid hipaccCreatePyramid(const HipaccImage &img, size_t depth, bool temporary=false);
 
 
 // forward declarations
 template<typename T>
 HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size_t height);
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base,
+                                                   const std::vector<size_t> &widths,
+                                                   const std::vector<size_t> &heights,
+                                                   bool temporary);
 
 
 #include "hipacc_base.tpp"
@@ -28,18 +28,24 @@
 
 
 template<typename data_t>
-HipaccPyramid hipaccCreatePyramid(const HipaccImage &img, size_t depth) {
+HipaccPyramid hipaccCreatePyramid(const HipaccImage &img, size_t depth, bool temporary) {
     HipaccPyramid p(depth);
     p.add(img);
 
+    std::vector<size_t> widths, heights;
     size_t width  = img->width  / 2;
     size_t height = img->height / 2;
     for (size_t i=1; i<depth; ++i) {
         assert(width * height > 0 && "Pyramid stages too deep for image size");
-        p.add(hipaccCreatePyramidImage<data_t>(img, width, height));
+        widths.push_back(width);
+        heights.push_back(height);
         width  /= 2;
         height /= 2;
     }
+
+    // the backend allocates all levels at once, e.g. from a single slab
+    for (auto level : hipaccCreatePyramidImages<data_t>(img, widths, heights, temporary))
+        p.add(level);
     return p;
 }
 
@@ -69,12 +69,44 @@ unsigned int nextPow2(unsigned int x) {
 }
 
 
+// Young/van Vliet recursive Gaussian (third order) and first-order
+// exponential smoothing; the gain of each pass is one, the Gaussian
+// approximation is valid for sigma >= 0.5
+hipacc_recursive_coeffs hipaccGetRecursiveCoeffs(float sigma, hipaccRecursiveMode mode) {
+    hipacc_recursive_coeffs coeffs = { 1.0f, 0.0f, 0.0f, 0.0f };
+
+    if (sigma <= 0.0f) return coeffs;
+
+    switch (mode) {
+        case RecursiveGaussian: {
+            sigma = std::max(sigma, 0.5f);
+            double q = sigma >= 2.5f ? 0.98711*sigma - 0.96330
+                                     : 3.97156 - 4.14554*std::sqrt(1.0 - 0.26891*sigma);
+            double q2 = q*q, q3 = q2*q;
+            double b0 = 1.57825 + 2.44413*q + 1.4281*q2 + 0.422205*q3;
+            coeffs.a1 = (float)((2.44413*q + 2.85619*q2 + 1.26661*q3) / b0);
+            coeffs.a2 = (float)(-(1.4281*q2 + 1.26661*q3) / b0);
+            coeffs.a3 = (float)(0.422205*q3 / b0);
+            break;
+        }
+        case RecursiveExponential:
+            coeffs.a1 = (float)std::exp(-1.0 / sigma);
+            break;
+    }
+    coeffs.b = 1.0f - (coeffs.a1 + coeffs.a2 + coeffs.a3);
+
+    return coeffs;
+}
+
+
 HipaccImageBase::HipaccImageBase(size_t width, size_t height, size_t stride,
-    size_t alignment, size_t pixel_size, void *mem, hipaccMemoryType mem_type)
+    size_t alignment, size_t pixel_size, void *mem, hipaccMemoryType mem_type,
+    bool alloc_host)
     : width(width), height(height), stride(stride), alignment(alignment),
       pixel_size(pixel_size), mem(mem), mem_type(mem_type),
-      host(new char[width*height*pixel_size]) {
-    std::fill(host, host + width*height*pixel_size, 0);
+      host(alloc_host ? new char[width*height*pixel_size] : nullptr) {
+    if (host)
+        std::fill(host, host + width*height*pixel_size, 0);
 }
 
 HipaccImageBase::~HipaccImageBase() {
@@ -121,6 +121,7 @@ std::vector<cl_device_id> hipaccGetAllDevices();
 void hipaccCreateContextsAndCommandQueues(bool all_devies=false, int num_kernel=0);
 void hipaccDumpBinary(cl_program program, cl_device_id device);
 cl_kernel hipaccBuildProgramAndKernel(std::string file_name, std::string kernel_name, bool print_progress=true, bool dump_binary=false, bool print_log=false, std::string build_options=std::string(), std::string build_includes=std::string());
+cl_kernel hipaccGetSourceKernel(const char *source, const std::string &build_options, const std::string &kernel_name);
 cl_sampler hipaccCreateSampler(cl_bool normalized_coords, cl_addressing_mode addressing_mode, cl_filter_mode filter_mode);
 void hipaccCopyMemory(const HipaccImage &src, HipaccImage &dst, int num_device=0);
 void hipaccCopyMemoryRegion(const HipaccAccessor &src, const HipaccAccessor &dst, int num_device=0);
@@ -176,6 +177,27 @@ template<typename T, typename T2>
 T *hipaccApplyBinningSegmented(cl_kernel kernel2D, cl_kernel kernel1D, const HipaccAccessor &acc, unsigned int num_hists, unsigned int num_warps, unsigned int num_bins);
 template<typename T>
 HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size_t height);
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base, const std::vector<size_t> &widths, const std::vector<size_t> &heights, bool temporary);
+
+
+// OpenCL C type names of the supported pixel and accumulator types
+template<typename T> struct hipaccCLTypeName;
+#define HIPACC_CL_TYPE_NAME(TYPE, NAME) \
+template<> struct hipaccCLTypeName<TYPE> { \
+    static const char *get() { return NAME; } \
+};
+HIPACC_CL_TYPE_NAME(char,               "char")
+HIPACC_CL_TYPE_NAME(unsigned char,      "uchar")
+HIPACC_CL_TYPE_NAME(short int,          "short")
+HIPACC_CL_TYPE_NAME(unsigned short int, "ushort")
+HIPACC_CL_TYPE_NAME(int,                "int")
+HIPACC_CL_TYPE_NAME(unsigned int,       "uint")
+HIPACC_CL_TYPE_NAME(long,               "long")
+HIPACC_CL_TYPE_NAME(unsigned long,      "ulong")
+HIPACC_CL_TYPE_NAME(float,              "float")
+HIPACC_CL_TYPE_NAME(double,             "double")
+#undef HIPACC_CL_TYPE_NAME
 
 
 #include "hipacc_cl.tpp"
@@ -510,5 +510,18 @@ HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size
 }
 
 
+// Levels are separate buffers: sub-buffers would have to be aligned to the
+// device's base address alignment and cannot back image objects
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base,
+    const std::vector<size_t> &widths, const std::vector<size_t> &heights,
+    bool) {
+  std::vector<HipaccImage> imgs;
+  for (size_t i=0; i<widths.size(); ++i)
+    imgs.push_back(hipaccCreatePyramidImage<T>(base, widths[i], heights[i]));
+  return imgs;
+}
+
+
 #endif  // __HIPACC_CL_TPP__
 
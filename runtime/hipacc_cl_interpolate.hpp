@@ -150,6 +150,30 @@ DATA_TYPE NAME(PARM, const int stride, float x_mapped, float y_mapped, const int
 }
 
 
+// Bilinear Interpolation in fixed-point arithmetic for 8/16-bit integer
+// images: 16.16 coordinates and 15-bit weights, rounded after each dimension
+#define INTERPOLATE_LINEAR_FILTERING_FIXED_OPENCL(NAME, DATA_TYPE, PARM, CPARM, ACCESS, ACCESS_ARR, BHXL, BHXU, BHYL, BHYU) \
+DATA_TYPE NAME(PARM, const int stride, float x_mapped, float y_mapped, const int rwidth, const int rheight, const int global_offset_x, const int global_offset_y CPARM) { \
+    int lower_x = global_offset_x, lower_y = global_offset_y; \
+    int upper_x = lower_x + rwidth, upper_y = lower_y + rheight; \
+    int xb = (int)(x_mapped * 65536.0f) - 32768; \
+    int yb = (int)(y_mapped * 65536.0f) - 32768; \
+    int x_int = (xb >> 16) + global_offset_x; \
+    int y_int = (yb >> 16) + global_offset_y; \
+    int x_frac = (xb >> 1) & 0x7fff; \
+    int y_frac = (yb >> 1) & 0x7fff; \
+    int x0 = BHXU(BHXL(x_int    , lower_x, upper_x), lower_x, upper_x); \
+    int x1 = BHXU(BHXL(x_int + 1, lower_x, upper_x), lower_x, upper_x); \
+    int y0 = BHYU(BHYL(y_int    , lower_y, upper_y), lower_y, upper_y); \
+    int y1 = BHYU(BHYL(y_int + 1, lower_y, upper_y), lower_y, upper_y); \
+ \
+    int top = ((int)(ACCESS(x0, y0, stride, const_val, ACCESS_ARR)) * (32768 - x_frac) + (int)(ACCESS(x1, y0, stride, const_val, ACCESS_ARR)) * x_frac + 16384) >> 15; \
+    int bot = ((int)(ACCESS(x0, y1, stride, const_val, ACCESS_ARR)) * (32768 - x_frac) + (int)(ACCESS(x1, y1, stride, const_val, ACCESS_ARR)) * x_frac + 16384) >> 15; \
+ \
+    return (DATA_TYPE)((top * (32768 - y_frac) + bot * y_frac + 16384) >> 15); \
+}
+
+
 // Cubic Interpolation
 float bicubic_spline(float diff) {
     diff = fabs(diff);
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __HIPACC_CL_RECURSIVE_HPP__
+#define __HIPACC_CL_RECURSIVE_HPP__
+
+#include <string>
+#include <type_traits>
+
+#include "hipacc_cl.hpp"
+
+// work-items per work-group, each work-item filters one row or column
+#ifndef HIPACC_RECURSIVE_BS
+#define HIPACC_RECURSIVE_BS 128
+#endif
+
+
+// recursive filter kernels, specialized by DATA_T at build time; integer
+// results are rounded to nearest and saturated (STORE_RTE)
+static const char *hipacc_cl_recursive_source =
+"#ifdef STORE_RTE\n"
+"#define CONVERT_RTE_(T, V) convert_##T##_sat_rte(V)\n"
+"#define CONVERT_RTE(T, V) CONVERT_RTE_(T, V)\n"
+"#define STORE(V) CONVERT_RTE(DATA_T, V)\n"
+"#else\n"
+"#define STORE(V) (DATA_T)(V)\n"
+"#endif\n"
+"\n"
+"// step 1:\n"
+"// causal and anti-causal pass along each row, one work-item per row\n"
+"__kernel void hipaccRecursiveRows(__global const DATA_T *input,\n"
+"        __global float *tmp, const int width, const int height,\n"
+"        const int stride, const float b, const float a1, const float a2,\n"
+"        const float a3) {\n"
+"    const int gid_y = get_global_id(0);\n"
+"    if (gid_y >= height) return;\n"
+"\n"
+"    __global const DATA_T *src = &input[gid_y * stride];\n"
+"    __global float *dst = &tmp[gid_y * width];\n"
+"\n"
+"    float y1 = (float)src[0], y2 = y1, y3 = y1;\n"
+"    for (int x = 0; x < width; ++x) {\n"
+"        float y0 = b*(float)src[x] + a1*y1 + a2*y2 + a3*y3;\n"
+"        dst[x] = y0;\n"
+"        y3 = y2; y2 = y1; y1 = y0;\n"
+"    }\n"
+"\n"
+"    y2 = y3 = y1;\n"
+"    for (int x = width-1; x >= 0; --x) {\n"
+"        float y0 = b*dst[x] + a1*y1 + a2*y2 + a3*y3;\n"
+"        dst[x] = y0;\n"
+"        y3 = y2; y2 = y1; y1 = y0;\n"
+"    }\n"
+"}\n"
+"\n"
+"// step 2:\n"
+"// causal and anti-causal pass along each column, one work-item per column\n"
+"__kernel void hipaccRecursiveColumns(__global float *tmp,\n"
+"        __global DATA_T *output, const int width, const int height,\n"
+"        const int stride, const float b, const float a1, const float a2,\n"
+"        const float a3) {\n"
+"    const int gid_x = get_global_id(0);\n"
+"    if (gid_x >= width) return;\n"
+"\n"
+"    float y1 = tmp[gid_x], y2 = y1, y3 = y1;\n"
+"    for (int y = 0; y < height; ++y) {\n"
+"        float y0 = b*tmp[y*width + gid_x] + a1*y1 + a2*y2 + a3*y3;\n"
+"        tmp[y*width + gid_x] = y0;\n"
+"        y3 = y2; y2 = y1; y1 = y0;\n"
+"    }\n"
+"\n"
+"    y2 = y3 = y1;\n"
+"    for (int y = height-1; y >= 0; --y) {\n"
+"        float y0 = b*tmp[y*width + gid_x] + a1*y1 + a2*y2 + a3*y3;\n"
+"        output[y*stride + gid_x] = STORE(y0);\n"
+"        y3 = y2; y2 = y1; y1 = y0;\n"
+"    }\n"
+"}\n";
+
+
+template<typename data_t>
+void hipaccRecursiveFilter(const HipaccImage &in, HipaccImage &out,
+                           float sigma,
+                           hipaccRecursiveMode mode=RecursiveGaussian) {
+    assert(in->width == out->width && in->height == out->height &&
+           "Size of input and output image have to be the same!");
+    assert(in->mem_type == Global && out->mem_type == Global &&
+           "Recursive filters require images in global memory!");
+
+    if (in->width == 0 || in->height == 0) return;
+
+    std::string options = std::string("-D DATA_T=") +
+                          hipaccCLTypeName<data_t>::get();
+    if (std::is_integral<data_t>::value)
+        options += " -D STORE_RTE";
+    cl_kernel rows = hipaccGetSourceKernel(hipacc_cl_recursive_source,
+                                           options, "hipaccRecursiveRows");
+    cl_kernel columns = hipaccGetSourceKernel(hipacc_cl_recursive_source,
+                                              options, "hipaccRecursiveColumns");
+
+    hipacc_recursive_coeffs coeffs = hipaccGetRecursiveCoeffs(sigma, mode);
+    cl_mem input = (cl_mem)in->mem, output = (cl_mem)out->mem;
+    int width = (int)in->width, height = (int)in->height;
+    int in_stride = (int)in->stride, out_stride = (int)out->stride;
+    cl_mem tmp = createBuffer<float>(width, height, CL_MEM_READ_WRITE);
+    float timing = 0.0f;
+
+    cl_kernel kernels[2] = { rows, columns };
+    for (int i=0; i<2; ++i) {
+        hipaccSetKernelArg(kernels[i], 2, sizeof(int), &width);
+        hipaccSetKernelArg(kernels[i], 3, sizeof(int), &height);
+        hipaccSetKernelArg(kernels[i], 5, sizeof(float), &coeffs.b);
+        hipaccSetKernelArg(kernels[i], 6, sizeof(float), &coeffs.a1);
+        hipaccSetKernelArg(kernels[i], 7, sizeof(float), &coeffs.a2);
+        hipaccSetKernelArg(kernels[i], 8, sizeof(float), &coeffs.a3);
+    }
+
+    hipaccSetKernelArg(rows, 0, sizeof(cl_mem), &input);
+    hipaccSetKernelArg(rows, 1, sizeof(cl_mem), &tmp);
+    hipaccSetKernelArg(rows, 4, sizeof(int), &in_stride);
+    size_t local[2] = { HIPACC_RECURSIVE_BS, 1 };
+    size_t rows_global[2] = { (height + HIPACC_RECURSIVE_BS - 1) /
+        HIPACC_RECURSIVE_BS * HIPACC_RECURSIVE_BS, 1 };
+    hipaccLaunchKernel(rows, rows_global, local, 0, false);
+    timing += last_gpu_timing;
+
+    hipaccSetKernelArg(columns, 0, sizeof(cl_mem), &tmp);
+    hipaccSetKernelArg(columns, 1, sizeof(cl_mem), &output);
+    hipaccSetKernelArg(columns, 4, sizeof(int), &out_stride);
+    size_t columns_global[2] = { (width + HIPACC_RECURSIVE_BS - 1) /
+        HIPACC_RECURSIVE_BS * HIPACC_RECURSIVE_BS, 1 };
+    hipaccLaunchKernel(columns, columns_global, local, 0, false);
+    timing += last_gpu_timing;
+
+    cl_int err = clReleaseMemObject(tmp);
+    checkErr(err, "clReleaseMemObject()");
+
+    last_gpu_timing = timing;
+    std::cerr << "<HIPACC:> Kernel timing (recursive filter): "
+              << last_gpu_timing << "(ms)" << std::endl;
+}
+
+
+#endif  // __HIPACC_CL_RECURSIVE_HPP__
+
@@ -0,0 +1,193 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __HIPACC_CL_SCAN_HPP__
+#define __HIPACC_CL_SCAN_HPP__
+
+#include <limits>
+#include <string>
+
+#include "hipacc_cl.hpp"
+
+// work-items per work-group of the row pass, each work-group scans chunks of
+// 2*BS pixels; has to be a power of two
+#ifndef HIPACC_SCAN_BS
+#define HIPACC_SCAN_BS 256
+#endif
+#ifndef HIPACC_SCAN_COLUMNS_BS
+#define HIPACC_SCAN_COLUMNS_BS 128
+#endif
+
+
+// scan kernels, specialized by ACC_T, DATA_T, SCAN_OP, and BS at build time
+static const char *hipacc_cl_scan_source =
+"#define SUM_OP(A, B) ((A) + (B))\n"
+"#define MIN_OP(A, B) ((B) < (A) ? (B) : (A))\n"
+"#define MAX_OP(A, B) ((A) < (B) ? (B) : (A))\n"
+"\n"
+"// step 1:\n"
+"// scan each row with one work-group: chunks of 2*BS pixels are scanned in\n"
+"// local memory using the work-efficient up-sweep/down-sweep scheme, the\n"
+"// total of the previous chunks is carried over to the next chunk\n"
+"__kernel __attribute__((reqd_work_group_size(BS, 1, 1)))\n"
+"void hipaccScanRows(__global const DATA_T *input, __global ACC_T *output,\n"
+"        const int width, const int in_stride, const int out_stride,\n"
+"        const ACC_T identity) {\n"
+"    __local ACC_T sdata[2*BS];\n"
+"    __local ACC_T carry;\n"
+"\n"
+"    const int tid = get_local_id(0);\n"
+"    __global const DATA_T *src = &input[get_group_id(1) * in_stride];\n"
+"    __global ACC_T *dst = &output[get_group_id(1) * out_stride];\n"
+"\n"
+"    if (tid == 0) carry = identity;\n"
+"\n"
+"    for (int base = 0; base < width; base += 2*BS) {\n"
+"        const int ia = base + tid;\n"
+"        const int ib = base + tid + BS;\n"
+"        const ACC_T va = ia < width ? (ACC_T)src[ia] : identity;\n"
+"        const ACC_T vb = ib < width ? (ACC_T)src[ib] : identity;\n"
+"        sdata[tid] = va;\n"
+"        sdata[tid + BS] = vb;\n"
+"\n"
+"        int offset = 1;\n"
+"        for (int d = BS; d > 0; d >>= 1) {\n"
+"            barrier(CLK_LOCAL_MEM_FENCE);\n"
+"            if (tid < d) {\n"
+"                const int ai = offset*(2*tid + 1) - 1;\n"
+"                const int bi = offset*(2*tid + 2) - 1;\n"
+"                sdata[bi] = SCAN_OP(sdata[ai], sdata[bi]);\n"
+"            }\n"
+"            offset <<= 1;\n"
+"        }\n"
+"\n"
+"        barrier(CLK_LOCAL_MEM_FENCE);\n"
+"        const ACC_T total = sdata[2*BS - 1];\n"
+"        barrier(CLK_LOCAL_MEM_FENCE);\n"
+"        if (tid == 0) sdata[2*BS - 1] = identity;\n"
+"        for (int d = 1; d <= BS; d <<= 1) {\n"
+"            offset >>= 1;\n"
+"            barrier(CLK_LOCAL_MEM_FENCE);\n"
+"            if (tid < d) {\n"
+"                const int ai = offset*(2*tid + 1) - 1;\n"
+"                const int bi = offset*(2*tid + 2) - 1;\n"
+"                const ACC_T t = sdata[ai];\n"
+"                sdata[ai] = sdata[bi];\n"
+"                sdata[bi] = SCAN_OP(sdata[bi], t);\n"
+"            }\n"
+"        }\n"
+"        barrier(CLK_LOCAL_MEM_FENCE);\n"
+"\n"
+"        const ACC_T prev = carry;\n"
+"        if (ia < width) dst[ia] = SCAN_OP(SCAN_OP(prev, sdata[tid]), va);\n"
+"        if (ib < width) dst[ib] = SCAN_OP(SCAN_OP(prev, sdata[tid + BS]), vb);\n"
+"        barrier(CLK_LOCAL_MEM_FENCE);\n"
+"        if (tid == 0) carry = SCAN_OP(prev, total);\n"
+"    }\n"
+"}\n"
+"\n"
+"// step 2:\n"
+"// accumulate the scanned rows vertically, one work-item per column\n"
+"__kernel void hipaccScanColumns(__global ACC_T *output, const int width,\n"
+"        const int height, const int stride) {\n"
+"    const int gid_x = get_global_id(0);\n"
+"    if (gid_x >= width) return;\n"
+"\n"
+"    ACC_T acc = output[gid_x];\n"
+"    for (int y = 1; y < height; ++y) {\n"
+"        acc = SCAN_OP(acc, output[y*stride + gid_x]);\n"
+"        output[y*stride + gid_x] = acc;\n"
+"    }\n"
+"}\n";
+
+
+template<typename acc_t, typename data_t>
+void hipaccIntegralImage(const HipaccImage &in, HipaccImage &out,
+                         hipaccScanMode mode=ScanSum) {
+    assert(in->width == out->width && in->height == out->height &&
+           "Size of input and output image have to be the same!");
+    assert(in->mem_type == Global && out->mem_type == Global &&
+           "Integral images require images in global memory!");
+
+    if (in->width == 0 || in->height == 0) return;
+
+    acc_t identity = acc_t();
+    std::string options = "-D BS=" + std::to_string(HIPACC_SCAN_BS) +
+                          " -D DATA_T=" + hipaccCLTypeName<data_t>::get() +
+                          " -D ACC_T=" + hipaccCLTypeName<acc_t>::get();
+    switch (mode) {
+        case ScanSum:
+            options += " -D SCAN_OP=SUM_OP";
+            break;
+        case ScanMin:
+            options += " -D SCAN_OP=MIN_OP";
+            identity = std::numeric_limits<acc_t>::max();
+            break;
+        case ScanMax:
+            options += " -D SCAN_OP=MAX_OP";
+            identity = std::numeric_limits<acc_t>::lowest();
+            break;
+    }
+
+    cl_kernel rows = hipaccGetSourceKernel(hipacc_cl_scan_source, options,
+                                           "hipaccScanRows");
+    cl_kernel columns = hipaccGetSourceKernel(hipacc_cl_scan_source, options,
+                                              "hipaccScanColumns");
+
+    cl_mem input = (cl_mem)in->mem, output = (cl_mem)out->mem;
+    int width = (int)in->width, height = (int)in->height;
+    int in_stride = (int)in->stride, out_stride = (int)out->stride;
+    float timing = 0.0f;
+
+    hipaccSetKernelArg(rows, 0, sizeof(cl_mem), &input);
+    hipaccSetKernelArg(rows, 1, sizeof(cl_mem), &output);
+    hipaccSetKernelArg(rows, 2, sizeof(int), &width);
+    hipaccSetKernelArg(rows, 3, sizeof(int), &in_stride);
+    hipaccSetKernelArg(rows, 4, sizeof(int), &out_stride);
+    hipaccSetKernelArg(rows, 5, sizeof(acc_t), &identity);
+    size_t rows_local[2] = { HIPACC_SCAN_BS, 1 };
+    size_t rows_global[2] = { HIPACC_SCAN_BS, (size_t)height };
+    hipaccLaunchKernel(rows, rows_global, rows_local, 0, false);
+    timing += last_gpu_timing;
+
+    hipaccSetKernelArg(columns, 0, sizeof(cl_mem), &output);
+    hipaccSetKernelArg(columns, 1, sizeof(int), &width);
+    hipaccSetKernelArg(columns, 2, sizeof(int), &height);
+    hipaccSetKernelArg(columns, 3, sizeof(int), &out_stride);
+    size_t columns_local[2] = { HIPACC_SCAN_COLUMNS_BS, 1 };
+    size_t columns_global[2] = { (width + HIPACC_SCAN_COLUMNS_BS - 1) /
+        HIPACC_SCAN_COLUMNS_BS * HIPACC_SCAN_COLUMNS_BS, 1 };
+    hipaccLaunchKernel(columns, columns_global, columns_local, 0, false);
+    timing += last_gpu_timing;
+
+    last_gpu_timing = timing;
+    std::cerr << "<HIPACC:> Kernel timing (integral image): "
+              << last_gpu_timing << "(ms)" << std::endl;
+}
+
+
+#endif  // __HIPACC_CL_SCAN_HPP__
+
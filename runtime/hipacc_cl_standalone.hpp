@@ -598,6 +598,48 @@ cl_kernel hipaccBuildProgramAndKernel(std::string file_name, std::string kernel_
 }
 
 
+
+// Build a kernel of the runtime library from source: programs are cached per
+// source and build options, kernels per program and name
+cl_kernel hipaccGetSourceKernel(const char *source, const std::string &build_options, const std::string &kernel_name) {
+    static std::map<std::pair<const char *, std::string>, cl_program> programs;
+    static std::map<std::pair<cl_program, std::string>, cl_kernel> kernels;
+    HipaccContext &Ctx = HipaccContext::getInstance();
+    cl_int err = CL_SUCCESS;
+
+    auto pit = programs.find(std::make_pair(source, build_options));
+    if (pit == programs.end()) {
+        const size_t length = strlen(source);
+        cl_program program = clCreateProgramWithSource(Ctx.get_contexts()[0], 1, &source, &length, &err);
+        checkErr(err, "clCreateProgramWithSource()");
+
+        err = clBuildProgram(program, 0, NULL, build_options.c_str(), NULL, NULL);
+        if (err != CL_SUCCESS) {
+            size_t log_size;
+            clGetProgramBuildInfo(program, Ctx.get_devices()[0], CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+            char *program_build_log = new char[log_size];
+            clGetProgramBuildInfo(program, Ctx.get_devices()[0], CL_PROGRAM_BUILD_LOG, log_size, program_build_log, NULL);
+            std::cerr << "<HIPACC:> OpenCL build options : " << std::endl
+                      << build_options << std::endl
+                      << "<HIPACC:> OpenCL build log : " << std::endl
+                      << program_build_log << std::endl;
+            delete[] program_build_log;
+        }
+        checkErr(err, "clBuildProgram()");
+
+        pit = programs.insert(std::make_pair(std::make_pair(source, build_options), program)).first;
+    }
+
+    auto kit = kernels.find(std::make_pair(pit->second, kernel_name));
+    if (kit == kernels.end()) {
+        cl_kernel kernel = clCreateKernel(pit->second, kernel_name.c_str(), &err);
+        checkErr(err, "clCreateKernel()");
+        kit = kernels.insert(std::make_pair(std::make_pair(pit->second, kernel_name), kernel)).first;
+    }
+
+    return kit->second;
+}
+
 #define CREATE_IMAGE(DATA_TYPE, CHANNEL_TYPE, CHANNEL_ORDER) \
 template <> \
 HipaccImage hipaccCreateImage<DATA_TYPE>(DATA_TYPE *host_mem, size_t width, size_t height) { \
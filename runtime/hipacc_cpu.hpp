@@ -26,24 +26,156 @@
 #ifndef __HIPACC_CPU_HPP__
 #define __HIPACC_CPU_HPP__
 
+#include <climits>
 #include <cmath>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "hipacc_base.hpp"
 
+// base alignment of image memory (cache line)
+#ifndef HIPACC_CPU_ALIGNMENT
+#define HIPACC_CPU_ALIGNMENT 64
+#endif
+// define HIPACC_CPU_HUGEPAGES to back large images by transparent huge pages
+// define HIPACC_CPU_NO_POOL to return image memory immediately to the system
+// bytes cached per memory pool, least recently released buffers are freed
+#ifndef HIPACC_CPU_POOL_BYTES
+#define HIPACC_CPU_POOL_BYTES ((size_t)1 << 30)
+#endif
+// define HIPACC_CPU_TASKS to run kernels on coarse pyramid levels as tasks
+// iteration spaces below this number of pixels are coarse
+#ifndef HIPACC_CPU_TASK_PIXELS
+#define HIPACC_CPU_TASK_PIXELS (256*256)
+#endif
+// vector register width in bytes vectorized kernels are strip-mined to
+#ifndef HIPACC_CPU_VECTOR_BYTES
+#if defined(__AVX512F__)
+#define HIPACC_CPU_VECTOR_BYTES 64
+#elif defined(__AVX__)
+#define HIPACC_CPU_VECTOR_BYTES 32
+#else
+#define HIPACC_CPU_VECTOR_BYTES 16
+#endif
+#endif
+
 class HipaccContext : public HipaccContextBase {
     public:
         static HipaccContext &getInstance();
 };
 
+// Recycles the memory of released images: buffers are cached by size and
+// handed out to the next image of the same size, e.g. in the next frame. At
+// most limit bytes are cached, the least recently released buffers are freed
+// first. Images keep the pool they were allocated from alive.
+class HipaccMemoryPool {
+    private:
+        // released buffers, least recently released first
+        std::list<std::pair<size_t, void*>> released;
+        std::multimap<size_t, std::list<std::pair<size_t, void*>>::iterator> buffers;
+        size_t cached, limit;
+        std::mutex mutex;
+
+        HipaccMemoryPool(HipaccMemoryPool const &);
+        void operator=(HipaccMemoryPool const &);
+        void evict(size_t max_bytes);
+
+    public:
+        explicit HipaccMemoryPool(size_t limit=HIPACC_CPU_POOL_BYTES)
+            : cached(0), limit(limit) {}
+        ~HipaccMemoryPool();
+        // pool of the innermost HipaccMemoryPoolScope of the calling thread,
+        // the global pool otherwise
+        static std::shared_ptr<HipaccMemoryPool> getCurrent();
+        void *allocate(size_t bytes);
+        void release(void *mem, size_t bytes);
+        void setLimit(size_t bytes);
+        void trim();
+};
+
+// Images allocated by the calling thread while the scope is alive, e.g. per
+// pipeline, are recycled in a pool of their own; its memory is returned to
+// the system once the scope and all of its images are gone
+class HipaccMemoryPoolScope {
+    private:
+        std::shared_ptr<HipaccMemoryPool> previous;
+
+        HipaccMemoryPoolScope(HipaccMemoryPoolScope const &);
+        void operator=(HipaccMemoryPoolScope const &);
+
+    public:
+        explicit HipaccMemoryPoolScope(size_t limit=HIPACC_CPU_POOL_BYTES);
+        ~HipaccMemoryPoolScope();
+};
+
+// Runs the kernels of pyramid traversals as tasks on a pool of threads, one
+// thread per kernel: dependencies are derived from the image memory read and
+// written by each kernel, so that independent kernels, e.g. of different
+// levels, run concurrently
+class HipaccTaskGraph {
+    private:
+        struct Task {
+            std::function<void()> func;
+            std::vector<Task*> successors;
+            int pending;
+            bool done;
+        };
+        struct Buffer {
+            Task *writer;
+            std::vector<Task*> readers;
+        };
+
+        std::vector<std::unique_ptr<Task>> tasks;
+        std::map<const void*, Buffer> buffers;
+        std::deque<Task*> ready;
+        std::vector<std::thread> workers;
+        size_t unfinished;
+        bool shutdown;
+        std::mutex mutex;
+        std::condition_variable cv_ready, cv_done;
+
+        HipaccTaskGraph() : unfinished(0), shutdown(false) {}
+        HipaccTaskGraph(HipaccTaskGraph const &);
+        void operator=(HipaccTaskGraph const &);
+        void addDependency(Task *task, Task *dep);
+        void work();
+
+    public:
+        static HipaccTaskGraph &getInstance();
+        ~HipaccTaskGraph();
+        void launch(std::initializer_list<const void*> reads,
+                    std::initializer_list<const void*> writes,
+                    const std::function<void()> &func);
+        void sync();
+};
+
+// CPU images live in host memory: the shadow host buffer of HipaccImageBase
+// is only allocated on demand, i.e. when a padded image is read back
 class HipaccImageCPU : public HipaccImageBase {
     private:
         char *mem;
+        bool own_mem;
+        // pool the memory is returned to
+        std::shared_ptr<HipaccMemoryPool> pool;
+        // image owning the memory of a view, e.g. the slab of a pyramid
+        HipaccImage parent;
     public:
         HipaccImageCPU(size_t width, size_t height, size_t stride,
                        size_t alignment, size_t pixel_size, void* mem,
-                       hipaccMemoryType mem_type=Global);
+                       hipaccMemoryType mem_type=Global, bool own_mem=true);
+        HipaccImageCPU(size_t width, size_t height, size_t stride,
+                       size_t alignment, size_t pixel_size, void* mem,
+                       const HipaccImage &parent);
         ~HipaccImageCPU();
 };
 
@@ -55,8 +187,122 @@ void hipaccStartTiming();
 void hipaccStopTiming();
 void hipaccCopyMemory(const HipaccImage &src, HipaccImage &dst);
 void hipaccCopyMemoryRegion(const HipaccAccessor &src, const HipaccAccessor &dst);
+void *hipaccAlignedAlloc(size_t bytes);
+void hipaccAlignedFree(void *mem);
+size_t hipaccAlignedStride(size_t width, size_t pixel_size, size_t alignment);
+void hipaccTrimMemoryPool();
+void hipaccLaunchKernel(std::initializer_list<const void*> reads, std::initializer_list<const void*> writes, size_t pixels, unsigned threads, const std::function<void()> &kernel);
+void hipaccSyncKernels();
 
 
+// Circular buffer of image rows for kernels fused into their consumer and for
+// the row pass of separable convolutions: rows are computed once per thread
+// and kernel execution (epoch) and reused by all pixels reading them
+template<typename T>
+class HipaccLineBuffer {
+    private:
+        T *mem;
+        int width, rows;
+        unsigned epoch;
+        std::vector<int> tags;
+
+        HipaccLineBuffer(HipaccLineBuffer const &);
+        void operator=(HipaccLineBuffer const &);
+
+    public:
+        HipaccLineBuffer() : mem(nullptr), width(0), rows(0), epoch(0) {}
+        ~HipaccLineBuffer() { hipaccAlignedFree(mem); }
+        T *getRow(int y, int width, int rows, unsigned epoch, bool &fill);
+};
+
+template<typename T>
+T *hipaccGetLineBufferRow(HipaccLineBuffer<T> &buffer, int y, int width, int rows, unsigned epoch, bool &fill);
+
+// Running column sums of separable box windows: per column the sum and the
+// row it belongs to (tag), kept per thread and kernel execution (epoch)
+template<typename T>
+class HipaccColumnSums {
+    private:
+        T *mem;
+        int width;
+        unsigned epoch;
+        std::vector<int> tags;
+
+        HipaccColumnSums(HipaccColumnSums const &);
+        void operator=(HipaccColumnSums const &);
+
+    public:
+        HipaccColumnSums() : mem(nullptr), width(0), epoch(0) {}
+        ~HipaccColumnSums() { hipaccAlignedFree(mem); }
+        T *get(int width, unsigned epoch, int *&tags);
+};
+
+template<typename T>
+T *hipaccGetColumnSums(HipaccColumnSums<T> &sums, int width, unsigned epoch, int *&tags);
+
+// Heap storage of lookup tables computed per kernel execution, e.g. for
+// range weights; kept per thread calling the kernel, so that concurrent tasks
+// executing the same kernel use their own tables
+template<typename T>
+class HipaccRangeTable {
+    private:
+        T *mem;
+        int size;
+
+        HipaccRangeTable(HipaccRangeTable const &);
+        void operator=(HipaccRangeTable const &);
+
+    public:
+        HipaccRangeTable() : mem(nullptr), size(0) {}
+        ~HipaccRangeTable() { hipaccAlignedFree(mem); }
+        T *get(int size);
+};
+
+template<typename T>
+T *hipaccGetRangeTable(HipaccRangeTable<T> &table, int size);
+
+
+// Histogram of the 8-bit values of a median window sliding along a row (Huang
+// et al.): for the pixel right of the previous one, only the column entering
+// the window is added and the column leaving it is removed; the window is
+// rebuilt for all other pixels and per kernel execution (epoch). Coarse bins
+// of 16 values bound the search for the median to 32 bins.
+template<typename T>
+class HipaccMedianHistogram {
+    private:
+        unsigned bins[256];
+        unsigned coarse[16];
+        // values of the window in columns, oldest column first
+        std::vector<T> values;
+        int size_x, size_y, column, pos;
+        int x, y;
+        unsigned epoch;
+
+        HipaccMedianHistogram(HipaccMedianHistogram const &);
+        void operator=(HipaccMedianHistogram const &);
+
+    public:
+        HipaccMedianHistogram() : size_x(0), size_y(0), column(0), pos(0),
+                                  x(0), y(0), epoch(0) {}
+        bool slide(int x, int y, int size_x, int size_y, unsigned epoch);
+        void add(T val) {
+            values[pos++] = val;
+            ++bins[(unsigned char)val];
+            ++coarse[(unsigned char)val >> 4];
+        }
+        T median() const;
+};
+
+template<typename T>
+bool hipaccSlideHistogram(HipaccMedianHistogram<T> &hist, int x, int y, int size_x, int size_y, unsigned epoch);
+template<typename T>
+void hipaccAddHistogram(HipaccMedianHistogram<T> &hist, T val);
+template<typename T>
+T hipaccGetHistogramMedian(const HipaccMedianHistogram<T> &hist);
+
+
+template<typename T>
+void touchMemory(T *mem, size_t stride, size_t height);
 template<typename T>
 HipaccImage createImage(T *host_mem, void *mem, size_t width, size_t height, size_t stride, size_t alignment, hipaccMemoryType mem_type=Global);
 template<typename T>
@@ -64,6 +310,14 @@ HipaccImage hipaccCreateMemory(T *host_mem, size_t width, size_t height, size_t
 template<typename T>
 HipaccImage hipaccCreateMemory(T *host_mem, size_t width, size_t height);
 template<typename T>
+HipaccImage hipaccCreateMemoryView(T *host_mem, size_t width, size_t height, size_t stride);
+template<typename T>
+HipaccImage hipaccCreateMemoryView(T *host_mem, size_t width, size_t height);
+template<typename T>
+HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size_t height);
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base, const std::vector<size_t> &widths, const std::vector<size_t> &heights, bool temporary);
+template<typename T>
 void hipaccWriteMemory(HipaccImage &img, T *host_mem);
 template<typename T>
 T *hipaccReadMemory(const HipaccImage &img);
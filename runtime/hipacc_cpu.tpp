@@ -27,10 +27,27 @@
 #define __HIPACC_CPU_TPP__
 
 
+// Zero image memory: first touch with the row partitioning of the kernels
+// (NUMA)
+template<typename T>
+void touchMemory(T *mem, size_t stride, size_t height) {
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int i=0; i<(int)height; ++i) {
+        std::fill(&mem[i*stride], &mem[(i+1)*stride], T());
+    }
+}
+
+
 template<typename T>
 HipaccImage createImage(T *host_mem, void *mem, size_t width, size_t height, size_t stride, size_t alignment, hipaccMemoryType mem_type) {
     HipaccImage img = std::make_shared<HipaccImageCPU>(width, height, stride, alignment, sizeof(T), mem, mem_type);
-    hipaccWriteMemory(img, host_mem ? host_mem : (T*)img->host);
+    if (host_mem) {
+        hipaccWriteMemory(img, host_mem);
+    } else {
+        touchMemory((T*)mem, stride, height);
+    }
 
     return img;
 }
@@ -39,64 +56,279 @@ HipaccImage createImage(T *host_mem, void *mem, size_t width, size_t height, siz
 // Allocate memory with alignment specified
 template<typename T>
 HipaccImage hipaccCreateMemory(T *host_mem, size_t width, size_t height, size_t alignment) {
-    // alignment has to be a multiple of sizeof(T)
-    alignment = (int)ceilf((float)alignment/sizeof(T)) * sizeof(T);
-    int stride = (int)ceilf((float)(width)/(alignment/sizeof(T))) * (alignment/sizeof(T));
+    size_t stride = hipaccAlignedStride(width, sizeof(T), alignment);
 
-    T *mem = new T[stride*height];
+    T *mem = (T *)HipaccMemoryPool::getCurrent()->allocate(sizeof(T)*stride*height);
     return createImage(host_mem, (void *)mem, width, height, stride, alignment);
 }
 
 
-// Allocate memory without any alignment considerations
+// Allocate memory without padding, only the base address is aligned
 template<typename T>
 HipaccImage hipaccCreateMemory(T *host_mem, size_t width, size_t height) {
-    T *mem = new T[width*height];
+    T *mem = (T *)HipaccMemoryPool::getCurrent()->allocate(sizeof(T)*width*height);
     return createImage(host_mem, (void *)mem, width, height, width, 0);
 }
 
 
+// Wrap existing memory (zero-copy): the image aliases host_mem, which has to
+// outlive the image and is not freed by the runtime
+template<typename T>
+HipaccImage hipaccCreateMemoryView(T *host_mem, size_t width, size_t height, size_t stride) {
+    assert(host_mem && stride >= width && "Invalid memory for image view.");
+    return std::make_shared<HipaccImageCPU>(width, height, stride, 0, sizeof(T), (void *)host_mem, Global, false);
+}
+
+
+template<typename T>
+HipaccImage hipaccCreateMemoryView(T *host_mem, size_t width, size_t height) {
+    return hipaccCreateMemoryView(host_mem, width, height, width);
+}
+
+
+// Allocate memory for Pyramid image
+template<typename T>
+HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size_t height) {
+    if (base->alignment > 0) {
+        return hipaccCreateMemory<T>(NULL, width, height, base->alignment);
+    } else {
+        return hipaccCreateMemory<T>(NULL, width, height);
+    }
+}
+
+
+// Allocate all Pyramid levels from one slab: each level is a view starting at
+// a cache line. Levels of temporary pyramids ping-pong between two regions:
+// level 1 (the base image is level 0) and level 2 get one region each, deeper
+// levels reuse the region of the level two stages above. As level 1 and 2 are
+// live at the same time, this saves only the levels from 3 on, i.e. about
+// 1/48 of the base image size or 6% of the allocated levels
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base, const std::vector<size_t> &widths, const std::vector<size_t> &heights, bool temporary) {
+    size_t num_levels = widths.size();
+    std::vector<size_t> strides(num_levels), offsets(num_levels);
+    size_t bytes = 0;
+    for (size_t i=0; i<num_levels; ++i) {
+        strides[i] = hipaccAlignedStride(widths[i], sizeof(T), base->alignment);
+        size_t size = sizeof(T)*strides[i]*heights[i];
+        size = (size + HIPACC_CPU_ALIGNMENT-1) / HIPACC_CPU_ALIGNMENT * HIPACC_CPU_ALIGNMENT;
+        // widths[i] and heights[i] describe level i+1
+        if (temporary && i >= 2) {
+            offsets[i] = offsets[i-2];
+        } else {
+            offsets[i] = bytes;
+            bytes += size;
+        }
+    }
+
+    std::vector<HipaccImage> imgs;
+    if (bytes == 0) return imgs;
+
+    void *mem = HipaccMemoryPool::getCurrent()->allocate(bytes);
+    HipaccImage slab = std::make_shared<HipaccImageCPU>(bytes, 1, bytes, 0, 1, mem);
+    for (size_t i=0; i<num_levels; ++i) {
+        T *level = (T*)((char*)mem + offsets[i]);
+        if (!temporary || i < 2)
+            touchMemory(level, strides[i], heights[i]);
+        imgs.push_back(std::make_shared<HipaccImageCPU>(widths[i], heights[i], strides[i], base->alignment, sizeof(T), (void*)level, slab));
+    }
+
+    return imgs;
+}
+
+
 // Write to memory
 template<typename T>
 void hipaccWriteMemory(HipaccImage &img, T *host_mem) {
     if (host_mem == nullptr) return;
+    hipaccSyncKernels();
 
     size_t width  = img->width;
     size_t height = img->height;
     size_t stride = img->stride;
 
-    if ((char *)host_mem != img->host)
-        std::copy(host_mem, host_mem + width*height, (T*)img->host);
+    // image wraps host_mem or host_mem is a view returned by hipaccReadMemory
+    if ((void *)host_mem == img->mem) return;
 
-    if (stride > width) {
-        for (size_t i=0; i<height; ++i) {
-            std::memcpy(&((T*)img->mem)[i*stride], &host_mem[i*width], sizeof(T)*width);
-        }
-    } else {
-        std::memcpy(img->mem, host_mem, sizeof(T)*width*height);
+    // copy row-wise with the partitioning of the kernels for first touch
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int i=0; i<(int)height; ++i) {
+        std::memcpy(&((T*)img->mem)[i*stride], &host_mem[i*width], sizeof(T)*width);
     }
 }
 
 
-// Read from memory
+// Read from memory: unpadded images are returned as view on the image memory,
+// padded images are compacted into the lazily allocated host buffer
 template<typename T>
 T *hipaccReadMemory(const HipaccImage &img) {
+    hipaccSyncKernels();
+
     size_t width  = img->width;
     size_t height = img->height;
     size_t stride = img->stride;
 
-    if (stride > width) {
-        for (size_t i=0; i<height; ++i) {
-            std::memcpy(&((T*)img->host)[i*width], &((T*)img->mem)[i*stride], sizeof(T)*width);
-        }
-    } else {
-        std::memcpy((T*)img->host, img->mem, sizeof(T)*width*height);
+    if (stride == width) return (T*)img->mem;
+
+    if (img->host == nullptr)
+        img->host = new char[sizeof(T)*width*height];
+
+    for (size_t i=0; i<height; ++i) {
+        std::memcpy(&((T*)img->host)[i*width], &((T*)img->mem)[i*stride], sizeof(T)*width);
     }
 
     return (T*)img->host;
 }
 
 
+// Get the buffer for row y; fill is set in case the row has to be computed
+template<typename T>
+T *HipaccLineBuffer<T>::getRow(int y, int width, int rows, unsigned epoch, bool &fill) {
+    if (width != this->width || rows != this->rows) {
+        hipaccAlignedFree(mem);
+        mem = (T*)hipaccAlignedAlloc(sizeof(T)*width*rows);
+        this->width = width;
+        this->rows = rows;
+        tags.assign(rows, INT_MIN);
+    }
+    if (epoch != this->epoch) {
+        tags.assign(rows, INT_MIN);
+        this->epoch = epoch;
+    }
+
+    // rows outside the image are requested by border handling
+    int slot = ((y % rows) + rows) % rows;
+    fill = tags[slot] != y;
+    tags[slot] = y;
+
+    return mem + slot*width;
+}
+
+
+// Get the buffer for row y of the given line buffer
+template<typename T>
+T *hipaccGetLineBufferRow(HipaccLineBuffer<T> &buffer, int y, int width, int rows, unsigned epoch, bool &fill) {
+    return buffer.getRow(y, width, rows, epoch, fill);
+}
+
+
+// Get the column sums; sums are valid for the rows given by their tags
+template<typename T>
+T *HipaccColumnSums<T>::get(int width, unsigned epoch, int *&tags) {
+    if (width != this->width) {
+        hipaccAlignedFree(mem);
+        mem = (T*)hipaccAlignedAlloc(sizeof(T)*width);
+        this->width = width;
+        this->tags.assign(width, INT_MIN);
+    }
+    if (epoch != this->epoch) {
+        this->tags.assign(width, INT_MIN);
+        this->epoch = epoch;
+    }
+    tags = this->tags.data();
+
+    return mem;
+}
+
+
+// Get the column sums of the given buffer
+template<typename T>
+T *hipaccGetColumnSums(HipaccColumnSums<T> &sums, int width, unsigned epoch, int *&tags) {
+    return sums.get(width, epoch, tags);
+}
+
+
+// Get storage for a table of size entries
+template<typename T>
+T *HipaccRangeTable<T>::get(int size) {
+    if (size != this->size) {
+        hipaccAlignedFree(mem);
+        mem = (T*)hipaccAlignedAlloc(sizeof(T)*size);
+        this->size = size;
+    }
+
+    return mem;
+}
+
+
+// Get storage for a table of size entries of the given range table
+template<typename T>
+T *hipaccGetRangeTable(HipaccRangeTable<T> &table, int size) {
+    return table.get(size);
+}
+
+
+// Move the window to pixel (x, y): returns true if the window slid by one
+// pixel and only the entering column has to be added, otherwise the histogram
+// is cleared and all values of the window have to be added column by column
+template<typename T>
+bool HipaccMedianHistogram<T>::slide(int x, int y, int size_x, int size_y, unsigned epoch) {
+    bool next = x == this->x + 1 && y == this->y && epoch == this->epoch &&
+                size_x == this->size_x && size_y == this->size_y;
+    this->x = x;
+    this->y = y;
+    this->epoch = epoch;
+
+    if (!next) {
+        this->size_x = size_x;
+        this->size_y = size_y;
+        values.resize(size_x*size_y);
+        std::memset(bins, 0, sizeof(bins));
+        std::memset(coarse, 0, sizeof(coarse));
+        column = 0;
+        pos = 0;
+        return false;
+    }
+
+    // remove the oldest column, the entering column takes its place
+    pos = column*size_y;
+    for (int i=0; i<size_y; ++i) {
+        unsigned char val = values[pos + i];
+        --bins[val];
+        --coarse[val >> 4];
+    }
+    column = column + 1 == size_x ? 0 : column + 1;
+
+    return true;
+}
+
+
+// Select the median, the upper one for an even number of values
+template<typename T>
+T HipaccMedianHistogram<T>::median() const {
+    unsigned half = size_x*size_y/2;
+    int block = 0;
+    unsigned cnt = coarse[0];
+    while (cnt <= half)
+        cnt += coarse[++block];
+
+    int bin = block*16 + 15;
+    cnt -= bins[bin];
+    while (cnt > half)
+        cnt -= bins[--bin];
+
+    return (T)bin;
+}
+
+
+template<typename T>
+bool hipaccSlideHistogram(HipaccMedianHistogram<T> &hist, int x, int y, int size_x, int size_y, unsigned epoch) {
+    return hist.slide(x, y, size_x, size_y, epoch);
+}
+
+template<typename T>
+void hipaccAddHistogram(HipaccMedianHistogram<T> &hist, T val) {
+    hist.add(val);
+}
+
+template<typename T>
+T hipaccGetHistogramMedian(const HipaccMedianHistogram<T> &hist) {
+    return hist.median();
+}
+
+
 // Infer non-const Domain from non-const Mask
 template<typename T>
 void hipaccWriteDomainFromMask(HipaccImage &dom, T* host_mem) {
@@ -0,0 +1,262 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __HIPACC_CPU_INTERPOLATE_HPP__
+#define __HIPACC_CPU_INTERPOLATE_HPP__
+
+#include <cmath>
+
+#define IMG_PARM(TYPE) const TYPE *img
+#define CONST_PARM(TYPE) , const TYPE const_val
+#define NO_PARM(TYPE)
+#define IMG(x, y, stride, const_val) img[(x) + (y)*(stride)]
+#define IMG_CONST(x, y, stride, const_val) (((x)<0||(y)<0)?const_val:img[(x) + (y)*(stride)])
+
+// border handling: CLAMP
+#define BH_CLAMP_LOWER(idx, lower, upper) bh_clamp_lower(idx, lower)
+#define BH_CLAMP_UPPER(idx, lower, upper) bh_clamp_upper(idx, upper)
+inline int bh_clamp_lower(int idx, int lower) {
+    if (idx  < lower) idx = lower;
+    return idx;
+}
+inline int bh_clamp_upper(int idx, int upper) {
+    if (idx >= upper) idx = upper-1;
+    return idx;
+}
+
+// border handling: REPEAT
+#define BH_REPEAT_LOWER(idx, lower, upper) bh_repeat_lower(idx, lower, upper)
+#define BH_REPEAT_UPPER(idx, lower, upper) bh_repeat_upper(idx, lower, upper)
+inline int bh_repeat_lower(int idx, int lower, int upper) {
+    if (idx  < lower) idx += lower + upper;
+    return idx;
+}
+inline int bh_repeat_upper(int idx, int lower, int upper) {
+    if (idx >= upper) idx -= lower + upper;
+    return idx;
+}
+
+// border handling: MIRROR
+#define BH_MIRROR_LOWER(idx, lower, upper) bh_mirror_lower(idx, lower)
+#define BH_MIRROR_UPPER(idx, lower, upper) bh_mirror_upper(idx, upper)
+inline int bh_mirror_lower(int idx, int lower) {
+    if (idx  < lower) idx = lower + (lower - idx-1);
+    return idx;
+}
+inline int bh_mirror_upper(int idx, int upper) {
+    if (idx >= upper) idx = upper - (idx+1 - upper);
+    return idx;
+}
+
+// border handling: CONSTANT
+#define BH_CONSTANT_LOWER(idx, lower, upper) bh_constant_lower(idx, lower)
+#define BH_CONSTANT_UPPER(idx, lower, upper) bh_constant_upper(idx, upper)
+inline int bh_constant_lower(int idx, int lower) {
+    if (idx  < lower) return -1;
+    return idx;
+}
+inline int bh_constant_upper(int idx, int upper) {
+    if (idx >= upper) return -1;
+    return idx;
+}
+
+// border handling: UNDEFINED
+#define NO_BH(idx, lower, upper) (idx)
+
+
+// no border handling
+#define DEFINE_BH_VARIANT_NO_BH(METHOD, DATA_TYPE, NAME, BH_LOWER, BH_UPPER, PARM, CPARM, ACC) \
+METHOD(NAME,        DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, NO_BH, NO_BH, NO_BH, NO_BH)
+
+// border handling
+#define DEFINE_BH_VARIANT(METHOD, DATA_TYPE, NAME, BH_LOWER, BH_UPPER, PARM, CPARM, ACC) \
+METHOD(NAME##_l,    DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, BH_LOWER, NO_BH, NO_BH, NO_BH) \
+METHOD(NAME##_r,    DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, NO_BH, BH_UPPER, NO_BH, NO_BH) \
+METHOD(NAME##_t,    DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, NO_BH, NO_BH, BH_LOWER, NO_BH) \
+METHOD(NAME##_b,    DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, NO_BH, NO_BH, NO_BH, BH_UPPER) \
+METHOD(NAME##_tl,   DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, BH_LOWER, NO_BH, BH_LOWER, NO_BH) \
+METHOD(NAME##_tr,   DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, NO_BH, BH_UPPER, BH_LOWER, NO_BH) \
+METHOD(NAME##_bl,   DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, BH_LOWER, NO_BH, NO_BH, BH_UPPER) \
+METHOD(NAME##_br,   DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, NO_BH, BH_UPPER, NO_BH, BH_UPPER) \
+METHOD(NAME##_tblr, DATA_TYPE, PARM(DATA_TYPE), CPARM(DATA_TYPE), ACC, BH_LOWER, BH_UPPER, BH_LOWER, BH_UPPER)
+
+#define SCALAR_TYPE_FUNS(TYPE) \
+typedef float float##TYPE; \
+inline TYPE float_to_##TYPE(float s) { \
+    return s; \
+} \
+inline float TYPE##_to_float(TYPE s) { \
+    return s; \
+}
+
+#define VECTOR_TYPE_FUNS(TYPE) \
+typedef float4 float##TYPE; \
+inline TYPE float_to_##TYPE(float4 v) { \
+    TYPE t; t.x = v.x; t.y = v.y; t.z = v.z; t.w = v.w; return t; \
+} \
+inline float4 TYPE##_to_float(TYPE v) { \
+    float4 t; t.x = v.x; t.y = v.y; t.z = v.z; t.w = v.w; return t; \
+}
+
+
+// Bilinear Interpolation
+#define INTERPOLATE_LINEAR_FILTERING_CPU(NAME, DATA_TYPE, PARM, CPARM, ACCESS, BHXL, BHXU, BHYL, BHYU) \
+inline DATA_TYPE NAME(PARM, const int stride, float x_mapped, float y_mapped, const int rwidth, const int rheight, const int global_offset_x, const int global_offset_y CPARM) { \
+    int lower_x = global_offset_x, lower_y = global_offset_y; \
+    int upper_x = lower_x + rwidth, upper_y = lower_y + rheight; \
+    float xb = x_mapped - 0.5f; \
+    float yb = y_mapped - 0.5f; \
+    int x_int = floorf(xb); \
+    int y_int = floorf(yb); \
+    float x_frac = xb - x_int; \
+    float y_frac = yb - y_int; \
+    x_int += global_offset_x; \
+    y_int += global_offset_y; \
+    int x0 = BHXU(BHXL(x_int    , lower_x, upper_x), lower_x, upper_x); \
+    int x1 = BHXU(BHXL(x_int + 1, lower_x, upper_x), lower_x, upper_x); \
+    int y0 = BHYU(BHYL(y_int    , lower_y, upper_y), lower_y, upper_y); \
+    int y1 = BHYU(BHYL(y_int + 1, lower_y, upper_y), lower_y, upper_y); \
+ \
+    return float_to_##DATA_TYPE( \
+        (1.0f - x_frac) * (1.0f - y_frac) * DATA_TYPE##_to_float(ACCESS(x0, y0, stride, const_val)) + \
+                x_frac  * (1.0f - y_frac) * DATA_TYPE##_to_float(ACCESS(x1, y0, stride, const_val)) + \
+        (1.0f - x_frac) *         y_frac  * DATA_TYPE##_to_float(ACCESS(x0, y1, stride, const_val)) + \
+                x_frac  *         y_frac  * DATA_TYPE##_to_float(ACCESS(x1, y1, stride, const_val))); \
+}
+
+
+// Bilinear Interpolation in fixed-point arithmetic for 8/16-bit integer
+// images: 16.16 coordinates and 15-bit weights, rounded after each dimension.
+// Only integer operations remain, which vectorize along the image rows
+#define INTERPOLATE_LINEAR_FILTERING_FIXED_CPU(NAME, DATA_TYPE, PARM, CPARM, ACCESS, BHXL, BHXU, BHYL, BHYU) \
+inline DATA_TYPE NAME(PARM, const int stride, float x_mapped, float y_mapped, const int rwidth, const int rheight, const int global_offset_x, const int global_offset_y CPARM) { \
+    int lower_x = global_offset_x, lower_y = global_offset_y; \
+    int upper_x = lower_x + rwidth, upper_y = lower_y + rheight; \
+    int xb = (int)(x_mapped * 65536.0f) - 32768; \
+    int yb = (int)(y_mapped * 65536.0f) - 32768; \
+    int x_int = (xb >> 16) + global_offset_x; \
+    int y_int = (yb >> 16) + global_offset_y; \
+    int x_frac = (xb >> 1) & 0x7fff; \
+    int y_frac = (yb >> 1) & 0x7fff; \
+    int x0 = BHXU(BHXL(x_int    , lower_x, upper_x), lower_x, upper_x); \
+    int x1 = BHXU(BHXL(x_int + 1, lower_x, upper_x), lower_x, upper_x); \
+    int y0 = BHYU(BHYL(y_int    , lower_y, upper_y), lower_y, upper_y); \
+    int y1 = BHYU(BHYL(y_int + 1, lower_y, upper_y), lower_y, upper_y); \
+ \
+    int top = ((int)(ACCESS(x0, y0, stride, const_val)) * (32768 - x_frac) + (int)(ACCESS(x1, y0, stride, const_val)) * x_frac + 16384) >> 15; \
+    int bot = ((int)(ACCESS(x0, y1, stride, const_val)) * (32768 - x_frac) + (int)(ACCESS(x1, y1, stride, const_val)) * x_frac + 16384) >> 15; \
+ \
+    return (DATA_TYPE)((top * (32768 - y_frac) + bot * y_frac + 16384) >> 15); \
+}
+
+
+// Cubic Interpolation
+inline float bicubic_spline(float diff) {
+    diff = fabsf(diff);
+    float a = -0.5f;
+
+    if (diff < 1.0f) {
+        return (a + 2.0f) *diff*diff*diff - (a + 3.0f)*diff*diff + 1.0f;
+    } else if (diff < 2.0f) {
+        return a * diff*diff*diff - 5.0f * a * diff*diff + 8.0f * a * diff - 4.0f * a;
+    } else {
+        return 0.0f;
+    }
+}
+
+#define INTERPOLATE_CUBIC_FILTERING_CPU(NAME, DATA_TYPE, PARM, CPARM, ACCESS, BHXL, BHXU, BHYL, BHYU) \
+inline DATA_TYPE NAME(PARM, const int stride, float x_mapped, float y_mapped, const int rwidth, const int rheight, const int global_offset_x, const int global_offset_y CPARM) { \
+    int lower_x = global_offset_x, lower_y = global_offset_y; \
+    int upper_x = lower_x + rwidth, upper_y = lower_y + rheight; \
+    float xb = x_mapped - 0.5f; \
+    float yb = y_mapped - 0.5f; \
+    int x_int = floorf(xb); \
+    int y_int = floorf(yb); \
+    float x_frac = xb - x_int; \
+    float y_frac = yb - y_int; \
+    x_int += global_offset_x; \
+    y_int += global_offset_y; \
+ \
+    float##DATA_TYPE sum = 0; \
+    for (int j=0; j<4; ++j) { \
+        int y = BHYU(BHYL(y_int - 1 + j, lower_y, upper_y), lower_y, upper_y); \
+        float##DATA_TYPE row = 0; \
+        for (int i=0; i<4; ++i) { \
+            int x = BHXU(BHXL(x_int - 1 + i, lower_x, upper_x), lower_x, upper_x); \
+            row += DATA_TYPE##_to_float(ACCESS(x, y, stride, const_val)) * bicubic_spline(x_frac + 1 - i); \
+        } \
+        sum += row * bicubic_spline(y_frac + 1 - j); \
+    } \
+ \
+    return float_to_##DATA_TYPE(sum); \
+}
+
+
+// Lanczos3 Interpolation
+#ifndef M_PI
+#define M_PI 3.141592654f
+#endif
+inline float lanczos(float diff) {
+    diff = fabsf(diff);
+    float l = 3.0f;
+
+    if (diff==0.0f) {
+        return 1.0f;
+    } else if (diff < l) {
+        return l * (sinf(M_PI*diff/l) * sinf(M_PI*diff)) / (M_PI*M_PI*diff*diff);
+    } else {
+        return 0.0f;
+    }
+}
+
+#define INTERPOLATE_LANCZOS_FILTERING_CPU(NAME, DATA_TYPE, PARM, CPARM, ACCESS, BHXL, BHXU, BHYL, BHYU) \
+inline DATA_TYPE NAME(PARM, const int stride, float x_mapped, float y_mapped, const int rwidth, const int rheight, const int global_offset_x, const int global_offset_y CPARM) { \
+    int lower_x = global_offset_x, lower_y = global_offset_y; \
+    int upper_x = lower_x + rwidth, upper_y = lower_y + rheight; \
+    float xb = x_mapped - 0.5f; \
+    float yb = y_mapped - 0.5f; \
+    int x_int = floorf(xb); \
+    int y_int = floorf(yb); \
+    float x_frac = xb - x_int; \
+    float y_frac = yb - y_int; \
+    x_int += global_offset_x; \
+    y_int += global_offset_y; \
+ \
+    float##DATA_TYPE sum = 0; \
+    for (int j=0; j<6; ++j) { \
+        int y = BHYU(BHYL(y_int - 2 + j, lower_y, upper_y), lower_y, upper_y); \
+        float##DATA_TYPE row = 0; \
+        for (int i=0; i<6; ++i) { \
+            int x = BHXU(BHXL(x_int - 2 + i, lower_x, upper_x), lower_x, upper_x); \
+            row += DATA_TYPE##_to_float(ACCESS(x, y, stride, const_val)) * lanczos(x_frac + 2 - i); \
+        } \
+        sum += row * lanczos(y_frac + 2 - j); \
+    } \
+ \
+    return float_to_##DATA_TYPE(sum); \
+}
+
+#endif  // __HIPACC_CPU_INTERPOLATE_HPP__
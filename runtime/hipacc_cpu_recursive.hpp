@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __HIPACC_CPU_RECURSIVE_HPP__
+#define __HIPACC_CPU_RECURSIVE_HPP__
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "hipacc_cpu.hpp"
+
+// number of columns filtered together by one task of the column pass
+#ifndef HIPACC_RECURSIVE_COLUMNS
+#define HIPACC_RECURSIVE_COLUMNS 64
+#endif
+
+
+template<typename T>
+inline T hipaccRecursiveStore(float val, std::true_type) {
+    return (T)std::floor(val + 0.5f);
+}
+template<typename T>
+inline T hipaccRecursiveStore(float val, std::false_type) {
+    return (T)val;
+}
+
+
+// Recursive filter: causal and anti-causal passes along rows and columns.
+// Rows are distributed across threads, columns are filtered in tasks of
+// HIPACC_RECURSIVE_COLUMNS adjacent columns so that the inner loop runs over
+// contiguous memory; borders are initialized with the steady state of the
+// border pixel (clamp)
+template<typename data_t>
+void hipaccRecursiveFilterKernel(const data_t *in, data_t *out, float *tmp,
+                                 int width, int height, int in_stride,
+                                 int out_stride,
+                                 const hipacc_recursive_coeffs &c) {
+    const float b = c.b, a1 = c.a1, a2 = c.a2, a3 = c.a3;
+
+    #ifdef _OPENMP
+    #pragma omp parallel
+    #endif
+    {
+        std::vector<float> line(width);
+
+        #ifdef _OPENMP
+        #pragma omp for schedule(static)
+        #endif
+        for (int y=0; y<height; ++y) {
+            const data_t *src = &in[y*in_stride];
+            float *dst = &tmp[y*width];
+
+            float y1 = (float)src[0], y2 = y1, y3 = y1;
+            for (int x=0; x<width; ++x) {
+                float y0 = b*(float)src[x] + a1*y1 + a2*y2 + a3*y3;
+                line[x] = y0;
+                y3 = y2; y2 = y1; y1 = y0;
+            }
+
+            y2 = y3 = y1;
+            for (int x=width-1; x>=0; --x) {
+                float y0 = b*line[x] + a1*y1 + a2*y2 + a3*y3;
+                dst[x] = y0;
+                y3 = y2; y2 = y1; y1 = y0;
+            }
+        }
+    }
+
+    const int num_tasks = (width + HIPACC_RECURSIVE_COLUMNS - 1) / HIPACC_RECURSIVE_COLUMNS;
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int t=0; t<num_tasks; ++t) {
+        const int x0 = t*HIPACC_RECURSIVE_COLUMNS;
+        const int n = std::min(HIPACC_RECURSIVE_COLUMNS, width - x0);
+        float y1[HIPACC_RECURSIVE_COLUMNS], y2[HIPACC_RECURSIVE_COLUMNS];
+        float y3[HIPACC_RECURSIVE_COLUMNS];
+
+        // causal pass, in place
+        for (int i=0; i<n; ++i) {
+            y1[i] = y2[i] = y3[i] = tmp[x0 + i];
+        }
+        for (int y=0; y<height; ++y) {
+            float *row = &tmp[y*width + x0];
+            for (int i=0; i<n; ++i) {
+                float y0 = b*row[i] + a1*y1[i] + a2*y2[i] + a3*y3[i];
+                row[i] = y0;
+                y3[i] = y2[i]; y2[i] = y1[i]; y1[i] = y0;
+            }
+        }
+
+        // anti-causal pass, starting from the last causal result
+        for (int i=0; i<n; ++i) {
+            y2[i] = y3[i] = y1[i];
+        }
+        for (int y=height-1; y>=0; --y) {
+            const float *row = &tmp[y*width + x0];
+            data_t *dst = &out[y*out_stride + x0];
+            for (int i=0; i<n; ++i) {
+                float y0 = b*row[i] + a1*y1[i] + a2*y2[i] + a3*y3[i];
+                dst[i] = hipaccRecursiveStore<data_t>(y0,
+                        std::is_integral<data_t>());
+                y3[i] = y2[i]; y2[i] = y1[i]; y1[i] = y0;
+            }
+        }
+    }
+}
+
+
+template<typename data_t>
+void hipaccRecursiveFilter(const HipaccImage &in, HipaccImage &out,
+                           float sigma,
+                           hipaccRecursiveMode mode=RecursiveGaussian) {
+    assert(in->width == out->width && in->height == out->height &&
+           "Size of input and output image have to be the same!");
+
+    int width = (int)in->width, height = (int)in->height;
+    if (width == 0 || height == 0) return;
+
+    hipacc_recursive_coeffs coeffs = hipaccGetRecursiveCoeffs(sigma, mode);
+    size_t bytes = sizeof(float)*width*height;
+    std::shared_ptr<HipaccMemoryPool> pool = HipaccMemoryPool::getCurrent();
+    float *tmp = (float *)pool->allocate(bytes);
+
+    hipaccStartTiming();
+    hipaccRecursiveFilterKernel<data_t>((const data_t *)in->mem,
+            (data_t *)out->mem, tmp, width, height, (int)in->stride,
+            (int)out->stride, coeffs);
+    hipaccStopTiming();
+
+    pool->release(tmp, bytes);
+}
+
+
+#endif  // __HIPACC_CPU_RECURSIVE_HPP__
+
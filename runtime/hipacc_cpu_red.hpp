@@ -1,117 +1,166 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
 #ifdef USE_OPENMP
 #  include <omp.h>
-#  define GET_NUM_CORES omp_get_num_procs()
+#  define GET_MAX_THREADS omp_get_max_threads()
+#  define GET_TEAM_SIZE omp_get_num_threads()
 #  define GET_THREAD_ID omp_get_thread_num()
-#  define OPENMP_PRAGMA _Pragma("omp parallel for")
+#  define OPENMP_PARALLEL _Pragma("omp parallel")
+#  define OPENMP_FOR _Pragma("omp for schedule(static)")
+#  define OPENMP_FOR_NOWAIT _Pragma("omp for schedule(static) nowait")
+#  define OPENMP_BARRIER _Pragma("omp barrier")
 #else
-#  define GET_NUM_CORES 1
+#  define GET_MAX_THREADS 1
+#  define GET_TEAM_SIZE 1
 #  define GET_THREAD_ID 0
-#  define OPENMP_PRAGMA
+#  define OPENMP_PARALLEL
+#  define OPENMP_FOR
+#  define OPENMP_FOR_NOWAIT
+#  define OPENMP_BARRIER
 #endif
 
+// the helpers are shared by all reduction kernels, whose files are included
+// into the same translation unit
+#ifndef __HIPACC_CPU_RED_HPP__
+#define __HIPACC_CPU_RED_HPP__
 
-#define REDUCTION_CPU_2D(NAME, DATA_TYPE, REDUCE, WIDTH, HEIGHT, PPT) \
-inline DATA_TYPE NAME ##Kernel(DATA_TYPE input[HEIGHT][WIDTH], int width, int height, int stride, int offset_x=0, int offset_y=0) { \
-    int num_cores = GET_NUM_CORES; \
- \
-    DATA_TYPE* part_result = new DATA_TYPE[num_cores]; \
-    int* init = new int[num_cores]; \
- \
-    for (int tid = 0; tid < num_cores; ++tid) { \
-        init[tid] = 1; \
+#define HIPACC_CACHE_LINE 64
+
+
+// size of per-thread data padded to full cache lines (no false sharing)
+inline size_t hipaccCacheLinePad(size_t bytes) {
+    return (bytes + HIPACC_CACHE_LINE - 1) / HIPACC_CACHE_LINE * HIPACC_CACHE_LINE;
+}
+
+
+// cache line aligned scratch memory for per-thread partial results, reused
+// across reductions of the calling host thread
+inline char *hipaccReductionScratch(size_t bytes) {
+    static thread_local std::unique_ptr<char[]> buffer;
+    static thread_local size_t size = 0;
+
+    if (size < bytes) {
+        buffer.reset(new char[bytes + HIPACC_CACHE_LINE]);
+        size = bytes;
+    }
+
+    uintptr_t addr = (uintptr_t)buffer.get();
+    return (char *)((addr + HIPACC_CACHE_LINE - 1) & ~(uintptr_t)(HIPACC_CACHE_LINE - 1));
+}
+
+#endif  // __HIPACC_CPU_RED_HPP__
+
+
+// REDUCE has to be associative and commutative: rows are reduced using four
+// independent accumulators so that the compiler can vectorize the inner loop
+#define REDUCTION_CPU_2D(NAME, DATA_TYPE, REDUCE) \
+struct NAME ##Partial { \
+    DATA_TYPE val; \
+    int valid; \
+}; \
+ \
+inline DATA_TYPE NAME ##Row(DATA_TYPE acc, const DATA_TYPE *row, int n) { \
+    int x = 0; \
+    if (n >= 8) { \
+        DATA_TYPE a0 = row[0], a1 = row[1], a2 = row[2], a3 = row[3]; \
+        for (x = 4; x + 4 <= n; x += 4) { \
+            a0 = REDUCE(a0, row[x]); \
+            a1 = REDUCE(a1, row[x+1]); \
+            a2 = REDUCE(a2, row[x+2]); \
+            a3 = REDUCE(a3, row[x+3]); \
+        } \
+        acc = REDUCE(acc, REDUCE(REDUCE(a0, a1), REDUCE(a2, a3))); \
+    } \
+    for (; x < n; ++x) { \
+        acc = REDUCE(acc, row[x]); \
     } \
+    return acc; \
+} \
  \
-    int end = height/PPT; \
+inline DATA_TYPE NAME ##Kernel(DATA_TYPE *input, int width, int height, int stride, int offset_x=0, int offset_y=0) { \
+    const size_t pad = hipaccCacheLinePad(sizeof(NAME ##Partial)); \
+    char *part = hipaccReductionScratch(GET_MAX_THREADS * pad); \
  \
-    OPENMP_PRAGMA \
-    for (int gid_y = 0; gid_y < end; ++gid_y) { \
+    OPENMP_PARALLEL \
+    { \
         const int tid = GET_THREAD_ID; \
-        int y = offset_y + gid_y * PPT; \
-        if (init[tid] == 1) part_result[tid] = input[y][offset_x]; \
- \
-        for (int p = 0; p < PPT; ++p) { \
-            int gy = y + p; \
-            for (int gid_x = offset_x + init[tid]; gid_x < offset_x + width; ++gid_x) { \
-                part_result[tid] = REDUCE(part_result[tid], input[gy][gid_x]); \
+        const int num_threads = GET_TEAM_SIZE; \
+        NAME ##Partial *own = (NAME ##Partial *)(part + tid*pad); \
+        DATA_TYPE acc = DATA_TYPE(); \
+        int valid = 0; \
+ \
+        OPENMP_FOR_NOWAIT \
+        for (int gy = offset_y; gy < offset_y + height; ++gy) { \
+            const DATA_TYPE *row = &input[gy*stride + offset_x]; \
+            if (valid) { \
+                acc = NAME ##Row(acc, row, width); \
+            } else { \
+                acc = NAME ##Row(row[0], row + 1, width - 1); \
+                valid = 1; \
             } \
-            init[tid] = 0; \
         } \
-    } \
- \
-    if (int missing = height%PPT) { \
-       int gid_y = offset_y + end * PPT; \
- \
-       OPENMP_PRAGMA \
-       for (int m = 0; m < missing; ++m) { \
-            const int tid = GET_THREAD_ID; \
-            int gy = gid_y + m; \
-            for (int gid_x = offset_x; gid_x < offset_x + width; ++gid_x) { \
-                part_result[tid] = REDUCE(part_result[tid], input[gy][gid_x]); \
+        own->val = acc; \
+        own->valid = valid; \
+        OPENMP_BARRIER \
+ \
+        /* tree merge of the partial results */ \
+        for (int step = 1; step < num_threads; step *= 2) { \
+            if (tid % (2*step) == 0 && tid + step < num_threads) { \
+                NAME ##Partial *other = (NAME ##Partial *)(part + (tid+step)*pad); \
+                if (other->valid) { \
+                    own->val = own->valid ? REDUCE(own->val, other->val) : other->val; \
+                    own->valid = 1; \
+                } \
             } \
-       } \
-    } \
- \
-    for (int i = 1; i < num_cores; ++i) { \
-        part_result[0] = REDUCE(part_result[0], part_result[i]); \
+            OPENMP_BARRIER \
+        } \
     } \
  \
-    DATA_TYPE result = part_result[0]; \
- \
-    delete [] init; \
-    delete [] part_result; \
- \
-    return result; \
+    return ((NAME ##Partial *)part)->val; \
 }
 
 
-#define BINNING_CPU_2D(NAME, DATA_TYPE, BIN_TYPE, REDUCE, BINNING, WIDTH, HEIGHT, PPT) \
+#define BINNING_CPU_2D(NAME, DATA_TYPE, BIN_TYPE, REDUCE, BINNING) \
 inline void BINNING ##Put(BIN_TYPE *_lmem, uint _offset, uint idx, BIN_TYPE val) { \
     if (idx < _offset) { \
         _lmem[idx] = REDUCE(_lmem[idx], val); \
     } \
 } \
  \
-inline BIN_TYPE* NAME ##Kernel(DATA_TYPE input[HEIGHT][WIDTH], uint num_bins, int width, int height, int stride, int offset_x=0, int offset_y=0) { \
-    int num_cores = GET_NUM_CORES; \
+inline BIN_TYPE* NAME ##Kernel(DATA_TYPE *input, uint num_bins, int width, int height, int stride, int offset_x=0, int offset_y=0) { \
+    const size_t pad = hipaccCacheLinePad(num_bins * sizeof(BIN_TYPE)); \
+    char *lbins = hipaccReductionScratch(GET_MAX_THREADS * pad); \
+    BIN_TYPE *bins = new BIN_TYPE[num_bins]; \
  \
-    BIN_TYPE *bins = new BIN_TYPE[num_bins](); \
-    BIN_TYPE *lbins = new BIN_TYPE[num_cores * num_bins](); \
-    int end = height/PPT; \
- \
-    OPENMP_PRAGMA \
-    for (int gid_y = 0; gid_y < end; ++gid_y) { \
+    OPENMP_PARALLEL \
+    { \
         const int tid = GET_THREAD_ID; \
-        int y = offset_y + gid_y * PPT; \
+        const int num_threads = GET_TEAM_SIZE; \
+        BIN_TYPE *own = (BIN_TYPE *)(lbins + tid*pad); \
+        for (uint i = 0; i < num_bins; ++i) { \
+            own[i] = BIN_TYPE(); \
+        } \
  \
-        for (int p = 0; p < PPT; ++p) { \
-            int gy = y + p; \
+        OPENMP_FOR_NOWAIT \
+        for (int gy = offset_y; gy < offset_y + height; ++gy) { \
             for (int gid_x = offset_x; gid_x < offset_x + width; ++gid_x) { \
-                BINNING(&lbins[tid * num_bins], num_bins, num_bins, gid_x, gy, input[gy][gid_x]); \
+                BINNING(own, num_bins, num_bins, gid_x, gy, input[gy*stride + gid_x]); \
             } \
         } \
-    } \
- \
-    if (int missing = height%PPT) { \
-       int gid_y = offset_y + end * PPT; \
- \
-       OPENMP_PRAGMA \
-       for (int m = 0; m < missing; ++m) { \
-            const int tid = GET_THREAD_ID; \
-            int gy = gid_y + m; \
-            for (int gid_x = offset_x; gid_x < offset_x + width; ++gid_x) { \
-                BINNING(&lbins[tid * num_bins], num_bins, num_bins, gid_x, gy, input[gy][gid_x]); \
+        OPENMP_BARRIER \
+ \
+        /* merge in parallel, each thread owns a range of bins */ \
+        OPENMP_FOR \
+        for (int i = 0; i < (int)num_bins; ++i) { \
+            BIN_TYPE val = ((BIN_TYPE *)lbins)[i]; \
+            for (int t = 1; t < num_threads; ++t) { \
+                val = REDUCE(val, ((BIN_TYPE *)(lbins + t*pad))[i]); \
             } \
-       } \
-    } \
- \
-    OPENMP_PRAGMA \
-    for (uint i = 0; i < num_bins; ++i) { \
-        for (int tid = 0; tid < num_cores; ++tid) { \
-            bins[i] = REDUCE(bins[i], lbins[tid * num_bins + i]); \
+            bins[i] = val; \
         } \
     } \
- \
-    delete [] lbins; \
  \
     return bins; \
 }
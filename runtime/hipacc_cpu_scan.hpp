@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __HIPACC_CPU_SCAN_HPP__
+#define __HIPACC_CPU_SCAN_HPP__
+
+#include <algorithm>
+
+#include "hipacc_cpu.hpp"
+
+// number of columns per task of the column pass, a multiple of cache lines
+#ifndef HIPACC_SCAN_COLUMNS
+#define HIPACC_SCAN_COLUMNS 256
+#endif
+
+
+struct hipaccScanSum {
+    template<typename T> static T apply(T a, T b) { return a + b; }
+};
+struct hipaccScanMin {
+    template<typename T> static T apply(T a, T b) { return b < a ? b : a; }
+};
+struct hipaccScanMax {
+    template<typename T> static T apply(T a, T b) { return a < b ? b : a; }
+};
+
+
+// 2D inclusive scan in two passes: rows are scanned in parallel, afterwards
+// the columns are accumulated by tasks of HIPACC_SCAN_COLUMNS adjacent
+// columns, so that each task streams over full cache lines of each row
+template<typename OP, typename acc_t, typename data_t>
+void hipaccIntegralImageKernel(const data_t *in, acc_t *out, int width,
+                               int height, int in_stride, int out_stride) {
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int y=0; y<height; ++y) {
+        const data_t *src = &in[y*in_stride];
+        acc_t *dst = &out[y*out_stride];
+        acc_t acc = (acc_t)src[0];
+        dst[0] = acc;
+        for (int x=1; x<width; ++x) {
+            acc = OP::apply(acc, (acc_t)src[x]);
+            dst[x] = acc;
+        }
+    }
+
+    const int num_tasks = (width + HIPACC_SCAN_COLUMNS - 1) / HIPACC_SCAN_COLUMNS;
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int t=0; t<num_tasks; ++t) {
+        const int x0 = t*HIPACC_SCAN_COLUMNS;
+        const int x1 = std::min(x0 + HIPACC_SCAN_COLUMNS, width);
+        for (int y=1; y<height; ++y) {
+            const acc_t *above = &out[(y-1)*out_stride];
+            acc_t *dst = &out[y*out_stride];
+            for (int x=x0; x<x1; ++x) {
+                dst[x] = OP::apply(above[x], dst[x]);
+            }
+        }
+    }
+}
+
+
+template<typename acc_t, typename data_t>
+void hipaccIntegralImage(const HipaccImage &in, HipaccImage &out,
+                         hipaccScanMode mode=ScanSum) {
+    assert(in->width == out->width && in->height == out->height &&
+           "Size of input and output image have to be the same!");
+
+    const data_t *src = (const data_t *)in->mem;
+    acc_t *dst = (acc_t *)out->mem;
+    int width = (int)in->width, height = (int)in->height;
+    int in_stride = (int)in->stride, out_stride = (int)out->stride;
+
+    if (width == 0 || height == 0) return;
+
+    hipaccStartTiming();
+    switch (mode) {
+        case ScanSum:
+            hipaccIntegralImageKernel<hipaccScanSum>(src, dst, width, height,
+                                                     in_stride, out_stride);
+            break;
+        case ScanMin:
+            hipaccIntegralImageKernel<hipaccScanMin>(src, dst, width, height,
+                                                     in_stride, out_stride);
+            break;
+        case ScanMax:
+            hipaccIntegralImageKernel<hipaccScanMax>(src, dst, width, height,
+                                                     in_stride, out_stride);
+            break;
+    }
+    hipaccStopTiming();
+}
+
+
+#endif  // __HIPACC_CPU_SCAN_HPP__
+
@@ -36,6 +36,19 @@
 
 #include "hipacc_base_standalone.hpp"
 
+#ifdef _MSC_VER
+#include <malloc.h>
+#else
+#include <cstdlib>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if defined(HIPACC_CPU_HUGEPAGES) && defined(__linux__)
+#include <sys/mman.h>
+#define HIPACC_CPU_HUGEPAGE_SIZE (2*1024*1024)
+#endif
+
 
 HipaccContext& HipaccContext::getInstance() {
     static HipaccContext instance;
@@ -45,19 +58,263 @@ HipaccContext& HipaccContext::getInstance() {
 
 HipaccImageCPU::HipaccImageCPU(size_t width, size_t height, size_t stride,
                size_t alignment, size_t pixel_size, void* mem,
-               hipaccMemoryType mem_type)
+               hipaccMemoryType mem_type, bool own_mem)
+    : HipaccImageBase(width, height, stride, alignment, pixel_size, mem,
+        mem_type, false), mem((char*)mem), own_mem(own_mem),
+      pool(own_mem ? HipaccMemoryPool::getCurrent() : nullptr) {
+}
+
+HipaccImageCPU::HipaccImageCPU(size_t width, size_t height, size_t stride,
+               size_t alignment, size_t pixel_size, void* mem,
+               const HipaccImage &parent)
     : HipaccImageBase(width, height, stride, alignment, pixel_size, mem,
-        mem_type), mem((char*)mem) {
+        Global, false), mem((char*)mem), own_mem(false), parent(parent) {
 }
 
 HipaccImageCPU::~HipaccImageCPU() {
-    delete[] mem;
+    if (own_mem)
+        pool->release(mem, stride*height*pixel_size);
+}
+
+
+// the global pool is never destroyed, so that images released at exit, e.g.
+// globals, still find it
+static std::shared_ptr<HipaccMemoryPool> &hipaccCurrentMemoryPool() {
+    static std::shared_ptr<HipaccMemoryPool> *global =
+        new std::shared_ptr<HipaccMemoryPool>(new HipaccMemoryPool);
+    static thread_local std::shared_ptr<HipaccMemoryPool> current = *global;
+
+    return current;
+}
+
+std::shared_ptr<HipaccMemoryPool> HipaccMemoryPool::getCurrent() {
+    return hipaccCurrentMemoryPool();
+}
+
+HipaccMemoryPool::~HipaccMemoryPool() {
+    trim();
+}
+
+void *HipaccMemoryPool::allocate(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = buffers.find(bytes);
+        if (it != buffers.end()) {
+            void *mem = it->second->second;
+            released.erase(it->second);
+            buffers.erase(it);
+            cached -= bytes;
+            return mem;
+        }
+    }
+
+    return hipaccAlignedAlloc(bytes);
+}
+
+void HipaccMemoryPool::release(void *mem, size_t bytes) {
+#ifdef HIPACC_CPU_NO_POOL
+    hipaccAlignedFree(mem);
+#else
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bytes > limit) {
+        hipaccAlignedFree(mem);
+        return;
+    }
+
+    released.push_back(std::make_pair(bytes, mem));
+    buffers.insert(std::make_pair(bytes, std::prev(released.end())));
+    cached += bytes;
+    evict(limit);
+#endif
+}
+
+// Free the least recently released buffers until at most max_bytes are
+// cached; the caller holds the lock
+void HipaccMemoryPool::evict(size_t max_bytes) {
+    while (cached > max_bytes) {
+        auto oldest = released.begin();
+        auto range = buffers.equal_range(oldest->first);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == oldest) {
+                buffers.erase(it);
+                break;
+            }
+        }
+        cached -= oldest->first;
+        hipaccAlignedFree(oldest->second);
+        released.erase(oldest);
+    }
+}
+
+void HipaccMemoryPool::setLimit(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    limit = bytes;
+    evict(limit);
+}
+
+// Return all cached buffers to the system, e.g. between pipelines
+void HipaccMemoryPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    evict(0);
+}
+
+void hipaccTrimMemoryPool() {
+    HipaccMemoryPool::getCurrent()->trim();
+}
+
+
+HipaccMemoryPoolScope::HipaccMemoryPoolScope(size_t limit)
+    : previous(hipaccCurrentMemoryPool()) {
+    hipaccCurrentMemoryPool() = std::make_shared<HipaccMemoryPool>(limit);
+}
+
+HipaccMemoryPoolScope::~HipaccMemoryPoolScope() {
+    hipaccCurrentMemoryPool() = previous;
+}
+
+
+HipaccTaskGraph &HipaccTaskGraph::getInstance() {
+    static HipaccTaskGraph instance;
+
+    return instance;
+}
+
+HipaccTaskGraph::~HipaccTaskGraph() {
+    sync();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shutdown = true;
+    }
+    cv_ready.notify_all();
+    for (auto &worker : workers)
+        worker.join();
 }
 
+void HipaccTaskGraph::addDependency(Task *task, Task *dep) {
+    if (dep && !dep->done) {
+        dep->successors.push_back(task);
+        ++task->pending;
+    }
+}
+
+void HipaccTaskGraph::work() {
+    // the kernel of a task runs on the thread of the task; kernels launched
+    // as tasks are compiled without num_threads clause
+    #ifdef _OPENMP
+    omp_set_num_threads(1);
+    #endif
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv_ready.wait(lock, [&] { return shutdown || !ready.empty(); });
+        if (ready.empty())
+            return;
+
+        Task *task = ready.front();
+        ready.pop_front();
+        lock.unlock();
+        task->func();
+        lock.lock();
+
+        // release the images captured by the kernel call
+        task->func = nullptr;
+        task->done = true;
+        for (auto succ : task->successors) {
+            if (--succ->pending == 0) {
+                ready.push_back(succ);
+                cv_ready.notify_one();
+            }
+        }
+        if (--unfinished == 0)
+            cv_done.notify_all();
+    }
+}
+
+void HipaccTaskGraph::launch(std::initializer_list<const void*> reads,
+                             std::initializer_list<const void*> writes,
+                             const std::function<void()> &func) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (workers.empty()) {
+        unsigned num_workers = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i=0; i<num_workers; ++i)
+            workers.emplace_back(&HipaccTaskGraph::work, this);
+    }
+
+    tasks.emplace_back(new Task{ func, {}, 0, false });
+    Task *task = tasks.back().get();
+
+    // read after write, write after read, and write after write
+    for (auto mem : reads)
+        addDependency(task, buffers[mem].writer);
+    for (auto mem : writes) {
+        addDependency(task, buffers[mem].writer);
+        for (auto reader : buffers[mem].readers)
+            addDependency(task, reader);
+    }
+    for (auto mem : reads)
+        buffers[mem].readers.push_back(task);
+    for (auto mem : writes) {
+        buffers[mem].writer = task;
+        buffers[mem].readers.clear();
+    }
+
+    ++unfinished;
+    if (task->pending == 0) {
+        ready.push_back(task);
+        cv_ready.notify_one();
+    }
+}
+
+// Wait for all tasks, required before the host accesses image memory
+void HipaccTaskGraph::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv_done.wait(lock, [&] { return unfinished == 0; });
+    tasks.clear();
+    buffers.clear();
+}
+
+
+// Launch kernel: kernels on coarse levels of a pyramid traversal are deferred
+// as tasks running on a single thread, all other kernels run immediately using
+// the given number of threads (0: OpenMP default)
+void hipaccLaunchKernel(std::initializer_list<const void*> reads, std::initializer_list<const void*> writes, size_t pixels, unsigned threads, const std::function<void()> &kernel) {
+#ifdef HIPACC_CPU_TASKS
+    if (!hipaccPyramids.empty() && pixels < HIPACC_CPU_TASK_PIXELS) {
+        HipaccTaskGraph::getInstance().launch(reads, writes, kernel);
+        last_gpu_timing = 0.0f;
+        return;
+    }
+#else
+    (void)reads; (void)writes; (void)pixels;
+#endif
+
+#ifdef _OPENMP
+    int max_threads = omp_get_max_threads();
+    if (threads)
+        omp_set_num_threads(threads);
+#else
+    (void)threads;
+#endif
+    hipaccStartTiming();
+    kernel();
+    hipaccStopTiming();
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+}
+
+void hipaccSyncKernels() {
+#ifdef HIPACC_CPU_TASKS
+    HipaccTaskGraph::getInstance().sync();
+#endif
+}
+
+
 long start_time = 0L;
 long end_time = 0L;
 
 void hipaccStartTiming() {
+    hipaccSyncKernels();
     start_time = hipacc_time_micro();
 }
 
@@ -72,6 +329,7 @@ void hipaccStopTiming() {
 
 // Copy from memory to memory
 void hipaccCopyMemory(const HipaccImage &src, HipaccImage &dst) {
+    hipaccSyncKernels();
     size_t height = src->height;
     size_t stride = src->stride;
     std::memcpy(dst->mem, src->mem, src->pixel_size*stride*height);
@@ -80,6 +338,7 @@ void hipaccCopyMemory(const HipaccImage &src, HipaccImage &dst) {
 
 // Copy from memory region to memory region
 void hipaccCopyMemoryRegion(const HipaccAccessor &src, const HipaccAccessor &dst) {
+    hipaccSyncKernels();
     for (size_t i=0; i<dst.height; ++i) {
         std::memcpy(&((uchar*)dst.img->mem)[dst.offset_x*dst.img->pixel_size + (dst.offset_y + i)*dst.img->stride*dst.img->pixel_size],
                     &((uchar*)src.img->mem)[src.offset_x*src.img->pixel_size + (src.offset_y + i)*src.img->stride*src.img->pixel_size],
@@ -88,5 +347,57 @@ void hipaccCopyMemoryRegion(const HipaccAccessor &src, const HipaccAccessor &dst
 }
 
 
+// Allocate memory aligned to HIPACC_CPU_ALIGNMENT bytes; the pages are not
+// touched, placement happens on first write (see hipaccWriteMemory)
+void *hipaccAlignedAlloc(size_t bytes) {
+    size_t alignment = HIPACC_CPU_ALIGNMENT;
+#ifdef HIPACC_CPU_HUGEPAGE_SIZE
+    if (bytes >= HIPACC_CPU_HUGEPAGE_SIZE) alignment = HIPACC_CPU_HUGEPAGE_SIZE;
+#endif
+
+    void *mem = nullptr;
+#ifdef _MSC_VER
+    mem = _aligned_malloc(bytes, alignment);
+#else
+    if (posix_memalign(&mem, alignment, bytes) != 0) mem = nullptr;
+#endif
+    assert(mem && "Allocation of image memory failed.");
+
+#ifdef HIPACC_CPU_HUGEPAGE_SIZE
+    if (bytes >= HIPACC_CPU_HUGEPAGE_SIZE) madvise(mem, bytes, MADV_HUGEPAGE);
+#endif
+
+    return mem;
+}
+
+
+void hipaccAlignedFree(void *mem) {
+#ifdef _MSC_VER
+    _aligned_free(mem);
+#else
+    free(mem);
+#endif
+}
+
+
+// Row stride in pixels: rows are padded to a multiple of alignment bytes and
+// strides that are a multiple of 4K get padded by another alignment unit
+// (a cache line by default), so that vertically adjacent pixels do not map
+// to the same cache set; the compiler mirrors this for constant image sizes
+size_t hipaccAlignedStride(size_t width, size_t pixel_size, size_t alignment) {
+    if (alignment == 0) return width;
+
+    // alignment has to be a multiple of pixel_size
+    alignment = (alignment + pixel_size - 1) / pixel_size * pixel_size;
+    size_t align_px = alignment / pixel_size;
+    size_t stride = (width + align_px - 1) / align_px * align_px;
+
+    if ((stride * pixel_size) % 4096 == 0)
+        stride += align_px;
+
+    return stride;
+}
+
+
 #endif  // __HIPACC_CPU_STANDALONE_HPP__
 
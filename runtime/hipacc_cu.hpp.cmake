@@ -149,10 +149,16 @@ class HipaccContext : public HipaccContextBase {
 
 
 class HipaccImageCUDA : public HipaccImageBase {
+    private:
+        // image owning the memory of a view, e.g. the slab of a pyramid
+        HipaccImage parent;
     public:
         HipaccImageCUDA(size_t width, size_t height, size_t stride,
                         size_t alignment, size_t pixel_size, void *mem,
-                        hipaccMemoryType mem_type=Global);
+                        hipaccMemoryType mem_type=Global, bool alloc_host=true);
+        HipaccImageCUDA(size_t width, size_t height, size_t stride,
+                        size_t alignment, size_t pixel_size, void *mem,
+                        const HipaccImage &parent);
         ~HipaccImageCUDA();
 };
 
@@ -205,6 +211,8 @@ HipaccImage hipaccCreateArray2D(T *host_mem, size_t width, size_t height);
 template<typename T>
 HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size_t height);
 template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base, const std::vector<size_t> &widths, const std::vector<size_t> &heights, bool temporary);
+template<typename T>
 void hipaccWriteMemory(HipaccImage &img, T *host_mem);
 template<typename T>
 T *hipaccReadMemory(const HipaccImage &img);
@@ -95,6 +95,60 @@ HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size
 }
 
 
+// Allocate all Pyramid levels from one slab: each level is a view starting at
+// a multiple of 256 bytes as required for texture binding. Levels of temporary
+// pyramids ping-pong between two regions: level 1 (the base image is level 0)
+// and level 2 get one region each, deeper levels reuse the region of the level
+// two stages above. As level 1 and 2 are live at the same time, this saves
+// only the levels from 3 on, i.e. about 1/48 of the base image size or 6% of
+// the allocated levels
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base, const std::vector<size_t> &widths, const std::vector<size_t> &heights, bool temporary) {
+    std::vector<HipaccImage> imgs;
+
+    // arrays cannot be sub-allocated
+    if (base->mem_type >= Array2D) {
+        for (size_t i=0; i<widths.size(); ++i)
+            imgs.push_back(hipaccCreatePyramidImage<T>(base, widths[i], heights[i]));
+        return imgs;
+    }
+
+    size_t num_levels = widths.size();
+    std::vector<size_t> strides(num_levels), offsets(num_levels);
+    size_t bytes = 0;
+    for (size_t i=0; i<num_levels; ++i) {
+        strides[i] = widths[i];
+        if (base->alignment > 0) {
+            size_t align_px = base->alignment / sizeof(T);
+            strides[i] = (widths[i] + align_px - 1) / align_px * align_px;
+        }
+        size_t size = (sizeof(T)*strides[i]*heights[i] + 255) / 256 * 256;
+        // widths[i] and heights[i] describe level i+1
+        if (temporary && i >= 2) {
+            offsets[i] = offsets[i-2];
+        } else {
+            offsets[i] = bytes;
+            bytes += size;
+        }
+    }
+
+    if (bytes == 0) return imgs;
+
+    char *mem;
+    cudaError_t err = cudaMalloc((void **) &mem, bytes);
+    checkErr(err, "cudaMalloc()");
+    err = cudaMemset(mem, 0, bytes);
+    checkErr(err, "cudaMemset()");
+
+    HipaccImage slab = std::make_shared<HipaccImageCUDA>(bytes, 1, bytes, 0, 1, (void *)mem, Global, false);
+    for (size_t i=0; i<num_levels; ++i) {
+        imgs.push_back(std::make_shared<HipaccImageCUDA>(widths[i], heights[i], strides[i], base->alignment, sizeof(T), (void *)(mem + offsets[i]), slab));
+    }
+
+    return imgs;
+}
+
+
 // Write to memory
 template<typename T>
 void hipaccWriteMemory(HipaccImage &img, T *host_mem) {
@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __HIPACC_CU_RECURSIVE_HPP__
+#define __HIPACC_CU_RECURSIVE_HPP__
+
+#include <type_traits>
+
+#include "hipacc_cu.hpp"
+
+// threads per block, each thread filters one row or column
+#ifndef HIPACC_RECURSIVE_BS
+#define HIPACC_RECURSIVE_BS 128
+#endif
+
+
+template<typename T>
+__device__ inline T hipaccRecursiveStoreCU(float val, std::true_type) {
+    return (T)floorf(val + 0.5f);
+}
+template<typename T>
+__device__ inline T hipaccRecursiveStoreCU(float val, std::false_type) {
+    return (T)val;
+}
+
+
+// step 1:
+// causal and anti-causal pass along each row, one thread per row
+template<typename data_t>
+__global__ void hipaccRecursiveRowsKernel(const data_t *input, float *tmp,
+        const int width, const int height, const int stride,
+        const hipacc_recursive_coeffs c) {
+    const int gid_y = blockIdx.x * blockDim.x + threadIdx.x;
+    if (gid_y >= height) return;
+
+    const data_t *src = &input[gid_y * stride];
+    float *dst = &tmp[gid_y * width];
+
+    float y1 = (float)src[0], y2 = y1, y3 = y1;
+    for (int x = 0; x < width; ++x) {
+        float y0 = c.b*(float)src[x] + c.a1*y1 + c.a2*y2 + c.a3*y3;
+        dst[x] = y0;
+        y3 = y2; y2 = y1; y1 = y0;
+    }
+
+    y2 = y3 = y1;
+    for (int x = width-1; x >= 0; --x) {
+        float y0 = c.b*dst[x] + c.a1*y1 + c.a2*y2 + c.a3*y3;
+        dst[x] = y0;
+        y3 = y2; y2 = y1; y1 = y0;
+    }
+}
+
+
+// step 2:
+// causal and anti-causal pass along each column, one thread per column so
+// that the accesses of each row are coalesced
+template<typename data_t>
+__global__ void hipaccRecursiveColumnsKernel(float *tmp, data_t *output,
+        const int width, const int height, const int stride,
+        const hipacc_recursive_coeffs c) {
+    const int gid_x = blockIdx.x * blockDim.x + threadIdx.x;
+    if (gid_x >= width) return;
+
+    float y1 = tmp[gid_x], y2 = y1, y3 = y1;
+    for (int y = 0; y < height; ++y) {
+        float y0 = c.b*tmp[y*width + gid_x] + c.a1*y1 + c.a2*y2 + c.a3*y3;
+        tmp[y*width + gid_x] = y0;
+        y3 = y2; y2 = y1; y1 = y0;
+    }
+
+    y2 = y3 = y1;
+    for (int y = height-1; y >= 0; --y) {
+        float y0 = c.b*tmp[y*width + gid_x] + c.a1*y1 + c.a2*y2 + c.a3*y3;
+        output[y*stride + gid_x] = hipaccRecursiveStoreCU<data_t>(y0,
+                std::is_integral<data_t>());
+        y3 = y2; y2 = y1; y1 = y0;
+    }
+}
+
+
+template<typename data_t>
+void hipaccRecursiveFilter(const HipaccImage &in, HipaccImage &out,
+                           float sigma,
+                           hipaccRecursiveMode mode=RecursiveGaussian) {
+    assert(in->width == out->width && in->height == out->height &&
+           "Size of input and output image have to be the same!");
+    assert(in->mem_type == Global && out->mem_type == Global &&
+           "Recursive filters require images in global memory!");
+
+    if (in->width == 0 || in->height == 0) return;
+
+    hipacc_recursive_coeffs coeffs = hipaccGetRecursiveCoeffs(sigma, mode);
+    const data_t *input = (const data_t *)in->mem;
+    data_t *output = (data_t *)out->mem;
+    int width = (int)in->width, height = (int)in->height;
+    int in_stride = (int)in->stride, out_stride = (int)out->stride;
+    float *tmp = createMemory<float>(width, height);
+    float timing = 0.0f;
+
+    void *row_args[] = { (void *)&input, (void *)&tmp, (void *)&width,
+                         (void *)&height, (void *)&in_stride,
+                         (void *)&coeffs };
+    dim3 row_grid((height + HIPACC_RECURSIVE_BS - 1) / HIPACC_RECURSIVE_BS);
+    hipaccLaunchKernel((const void *)&hipaccRecursiveRowsKernel<data_t>,
+                       "hipaccRecursiveRowsKernel", row_grid,
+                       dim3(HIPACC_RECURSIVE_BS), row_args, false);
+    timing += last_gpu_timing;
+
+    void *col_args[] = { (void *)&tmp, (void *)&output, (void *)&width,
+                         (void *)&height, (void *)&out_stride,
+                         (void *)&coeffs };
+    dim3 col_grid((width + HIPACC_RECURSIVE_BS - 1) / HIPACC_RECURSIVE_BS);
+    hipaccLaunchKernel((const void *)&hipaccRecursiveColumnsKernel<data_t>,
+                       "hipaccRecursiveColumnsKernel", col_grid,
+                       dim3(HIPACC_RECURSIVE_BS), col_args, false);
+    timing += last_gpu_timing;
+
+    cudaError_t err = cudaFree(tmp);
+    checkErr(err, "cudaFree()");
+
+    last_gpu_timing = timing;
+    std::cerr << "<HIPACC:> Kernel timing (recursive filter): "
+              << last_gpu_timing << "(ms)" << std::endl;
+}
+
+
+#endif  // __HIPACC_CU_RECURSIVE_HPP__
+
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2012, University of Erlangen-Nuremberg
+// Copyright (c) 2012, Siemens AG
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef __HIPACC_CU_SCAN_HPP__
+#define __HIPACC_CU_SCAN_HPP__
+
+#include <limits>
+
+#include "hipacc_cu.hpp"
+
+// threads per block of the row pass, each block scans chunks of 2*BS pixels
+#ifndef HIPACC_SCAN_BS
+#define HIPACC_SCAN_BS 256
+#endif
+#ifndef HIPACC_SCAN_COLUMNS_BS
+#define HIPACC_SCAN_COLUMNS_BS 128
+#endif
+
+
+struct hipaccScanSumCU {
+    template<typename T> __device__ static T apply(T a, T b) { return a + b; }
+};
+struct hipaccScanMinCU {
+    template<typename T> __device__ static T apply(T a, T b) { return b < a ? b : a; }
+};
+struct hipaccScanMaxCU {
+    template<typename T> __device__ static T apply(T a, T b) { return a < b ? b : a; }
+};
+
+
+// step 1:
+// scan each row with one block: chunks of 2*HIPACC_SCAN_BS pixels are scanned
+// in shared memory using the work-efficient up-sweep/down-sweep scheme, the
+// total of the previous chunks is carried over to the next chunk
+template<typename OP, typename acc_t, typename data_t>
+__global__ __launch_bounds__(HIPACC_SCAN_BS) void hipaccScanRowsKernel(
+        const data_t *input, acc_t *output, const int width,
+        const int in_stride, const int out_stride, const acc_t identity) {
+    __shared__ acc_t sdata[2*HIPACC_SCAN_BS];
+    __shared__ acc_t carry;
+
+    const int tid = threadIdx.x;
+    const data_t *src = &input[blockIdx.x * in_stride];
+    acc_t *dst = &output[blockIdx.x * out_stride];
+
+    if (tid == 0) carry = identity;
+
+    for (int base = 0; base < width; base += 2*HIPACC_SCAN_BS) {
+        const int ia = base + tid;
+        const int ib = base + tid + HIPACC_SCAN_BS;
+        const acc_t va = ia < width ? (acc_t)src[ia] : identity;
+        const acc_t vb = ib < width ? (acc_t)src[ib] : identity;
+        sdata[tid] = va;
+        sdata[tid + HIPACC_SCAN_BS] = vb;
+
+        // up-sweep: build partial results in place
+        int offset = 1;
+        for (int d = HIPACC_SCAN_BS; d > 0; d >>= 1) {
+            __syncthreads();
+            if (tid < d) {
+                const int ai = offset*(2*tid + 1) - 1;
+                const int bi = offset*(2*tid + 2) - 1;
+                sdata[bi] = OP::apply(sdata[ai], sdata[bi]);
+            }
+            offset <<= 1;
+        }
+
+        // down-sweep: exclusive scan of the chunk
+        __syncthreads();
+        const acc_t total = sdata[2*HIPACC_SCAN_BS - 1];
+        __syncthreads();
+        if (tid == 0) sdata[2*HIPACC_SCAN_BS - 1] = identity;
+        for (int d = 1; d <= HIPACC_SCAN_BS; d <<= 1) {
+            offset >>= 1;
+            __syncthreads();
+            if (tid < d) {
+                const int ai = offset*(2*tid + 1) - 1;
+                const int bi = offset*(2*tid + 2) - 1;
+                const acc_t t = sdata[ai];
+                sdata[ai] = sdata[bi];
+                sdata[bi] = OP::apply(sdata[bi], t);
+            }
+        }
+        __syncthreads();
+
+        const acc_t prev = carry;
+        if (ia < width) dst[ia] = OP::apply(OP::apply(prev, sdata[tid]), va);
+        if (ib < width) dst[ib] = OP::apply(OP::apply(prev, sdata[tid + HIPACC_SCAN_BS]), vb);
+        __syncthreads();
+        if (tid == 0) carry = OP::apply(prev, total);
+    }
+}
+
+
+// step 2:
+// accumulate the scanned rows vertically, one thread per column so that the
+// accesses of each row are coalesced
+template<typename OP, typename acc_t>
+__global__ void hipaccScanColumnsKernel(acc_t *output, const int width,
+        const int height, const int stride) {
+    const int gid_x = blockIdx.x * blockDim.x + threadIdx.x;
+    if (gid_x >= width) return;
+
+    acc_t acc = output[gid_x];
+    for (int y = 1; y < height; ++y) {
+        acc = OP::apply(acc, output[y*stride + gid_x]);
+        output[y*stride + gid_x] = acc;
+    }
+}
+
+
+template<typename OP, typename acc_t, typename data_t>
+void hipaccIntegralImageCU(const HipaccImage &in, HipaccImage &out,
+                           acc_t identity) {
+    const data_t *input = (const data_t *)in->mem;
+    acc_t *output = (acc_t *)out->mem;
+    int width = (int)in->width, height = (int)in->height;
+    int in_stride = (int)in->stride, out_stride = (int)out->stride;
+    float timing = 0.0f;
+
+    void *row_args[] = { (void *)&input, (void *)&output, (void *)&width,
+                         (void *)&in_stride, (void *)&out_stride,
+                         (void *)&identity };
+    hipaccLaunchKernel((const void *)&hipaccScanRowsKernel<OP, acc_t, data_t>,
+                       "hipaccScanRowsKernel", dim3(height),
+                       dim3(HIPACC_SCAN_BS), row_args, false);
+    timing += last_gpu_timing;
+
+    void *col_args[] = { (void *)&output, (void *)&width, (void *)&height,
+                         (void *)&out_stride };
+    dim3 grid((width + HIPACC_SCAN_COLUMNS_BS - 1) / HIPACC_SCAN_COLUMNS_BS);
+    hipaccLaunchKernel((const void *)&hipaccScanColumnsKernel<OP, acc_t>,
+                       "hipaccScanColumnsKernel", grid,
+                       dim3(HIPACC_SCAN_COLUMNS_BS), col_args, false);
+    timing += last_gpu_timing;
+
+    last_gpu_timing = timing;
+    std::cerr << "<HIPACC:> Kernel timing (integral image): "
+              << last_gpu_timing << "(ms)" << std::endl;
+}
+
+
+template<typename acc_t, typename data_t>
+void hipaccIntegralImage(const HipaccImage &in, HipaccImage &out,
+                         hipaccScanMode mode=ScanSum) {
+    assert(in->width == out->width && in->height == out->height &&
+           "Size of input and output image have to be the same!");
+    assert(in->mem_type == Global && out->mem_type == Global &&
+           "Integral images require images in global memory!");
+
+    if (in->width == 0 || in->height == 0) return;
+
+    switch (mode) {
+        case ScanSum:
+            hipaccIntegralImageCU<hipaccScanSumCU, acc_t, data_t>(in, out,
+                    acc_t());
+            break;
+        case ScanMin:
+            hipaccIntegralImageCU<hipaccScanMinCU, acc_t, data_t>(in, out,
+                    std::numeric_limits<acc_t>::max());
+            break;
+        case ScanMax:
+            hipaccIntegralImageCU<hipaccScanMaxCU, acc_t, data_t>(in, out,
+                    std::numeric_limits<acc_t>::lowest());
+            break;
+    }
+}
+
+
+#endif  // __HIPACC_CU_SCAN_HPP__
+
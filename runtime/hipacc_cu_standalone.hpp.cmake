@@ -61,13 +61,24 @@ HipaccContext& HipaccContext::getInstance() {
 
 HipaccImageCUDA::HipaccImageCUDA(size_t width, size_t height, size_t stride,
                                  size_t alignment, size_t pixel_size, void *mem,
-                                 hipaccMemoryType mem_type)
-  : HipaccImageBase(width, height, stride, alignment, pixel_size, mem, mem_type)
+                                 hipaccMemoryType mem_type, bool alloc_host)
+  : HipaccImageBase(width, height, stride, alignment, pixel_size, mem, mem_type,
+                    alloc_host)
+{}
+
+
+HipaccImageCUDA::HipaccImageCUDA(size_t width, size_t height, size_t stride,
+                                 size_t alignment, size_t pixel_size, void *mem,
+                                 const HipaccImage &parent)
+  : HipaccImageBase(width, height, stride, alignment, pixel_size, mem, Global),
+    parent(parent)
 {}
 
 
 HipaccImageCUDA::~HipaccImageCUDA() {
-    if (mem_type >= Array2D) {
+    if (parent) {
+        // memory is owned by the parent image
+    } else if (mem_type >= Array2D) {
         cudaError_t err = cudaFreeArray((cudaArray *)mem);
         checkErr(err, "cudaFreeArray()");
     } else {
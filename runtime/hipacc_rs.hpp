@@ -205,6 +205,8 @@ T hipaccApplyReduction(
     int is_width, bool print_timing=true);
 template<typename T>
 HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size_t height);
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base, const std::vector<size_t> &widths, const std::vector<size_t> &heights, bool temporary);
 
 
 #include "hipacc_rs.tpp"
@@ -377,4 +377,16 @@ HipaccImage hipaccCreatePyramidImage(const HipaccImage &base, size_t width, size
 }
 
 
+// Levels are separate Allocations, which cannot alias each other
+template<typename T>
+std::vector<HipaccImage> hipaccCreatePyramidImages(const HipaccImage &base,
+        const std::vector<size_t> &widths, const std::vector<size_t> &heights,
+        bool) {
+    std::vector<HipaccImage> imgs;
+    for (size_t i=0; i<widths.size(); ++i)
+        imgs.push_back(hipaccCreatePyramidImage<T>(base, widths[i], heights[i]));
+    return imgs;
+}
+
+
 #endif  // __HIPACC_RS_TPP__
@@ -17,6 +17,7 @@
 #include <ap_int.h>
 #include <hls_stream.h>
 #include <assert.h>
+#include <math.h>
 #include <typeinfo>
 #include <iostream>
 #define ASSERTION_CHECK
@@ -4336,6 +4337,151 @@ void splitStream4(
     }
 }
 
+//*********************************************************************************************************************
+// RECURSIVE FILTERS
+//*********************************************************************************************************************
+// y[n] = b*x[n] + a1*y[n-1] + a2*y[n-2] + a3*y[n-3], see
+// hipaccGetRecursiveCoeffs() for the coefficients of Gaussian and exponential
+// smoothing; the recursion limits the initiation interval to the latency of
+// the floating point accumulation
+
+// rows of the column pass buffered per band: the anti-causal pass of a band
+// starts HIPACC_RECURSIVE_BAND rows further down
+#ifndef HIPACC_RECURSIVE_BAND
+#define HIPACC_RECURSIVE_BAND 32
+#endif
+
+// integer outputs are rounded to nearest like in the CPU and GPU implementations
+template<typename OUT>
+inline OUT recursiveStore(const float val) { return (OUT)floorf(val + 0.5f); }
+template<>
+inline float recursiveStore<float>(const float val) { return val; }
+template<>
+inline double recursiveStore<double>(const float val) { return (double)val; }
+
+// causal and anti-causal pass along each row, double buffered: the causal
+// pass of a row fills one line buffer while the previous row is streamed out
+// of the other one; the anti-causal pass runs in place in reverse order
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, typename IN>
+void processRecursiveRows(
+    hls::stream<IN> &in_s,
+    hls::stream<float> &out_s,
+    const int &width,
+    const int &height,
+    const float b, const float a1, const float a2, const float a3)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  float line[2][MAX_WIDTH];
+  #pragma HLS ARRAY_PARTITION variable=line dim=1 complete
+
+  for (int y = 0; y <= height; ++y) {
+    const int cur = y & 1;
+    float y1 = 0, y2 = 0, y3 = 0;
+    for (int x = 0; x < width; ++x) {
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      #pragma HLS dependence variable=line inter false
+      if (y > 0)
+        out_s.write(line[cur ^ 1][x]);
+      if (y < height) {
+        const float val = (float)in_s.read();
+        if (x == 0) { y1 = val; y2 = val; y3 = val; }
+        const float y0 = b*val + a1*y1 + a2*y2 + a3*y3;
+        line[cur][x] = y0;
+        y3 = y2; y2 = y1; y1 = y0;
+      }
+    }
+    if (y == height)
+      break;
+
+    y2 = y1; y3 = y1;
+    for (int x = width-1; x >= 0; --x) {
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      const float y0 = b*line[cur][x] + a1*y1 + a2*y2 + a3*y3;
+      line[cur][x] = y0;
+      y3 = y2; y2 = y1; y1 = y0;
+    }
+  }
+}
+
+// causal and anti-causal pass along each column with one state per column,
+// buffering 2*HIPACC_RECURSIVE_BAND rows instead of a frame: once a band of
+// rows is followed by another band, the anti-causal pass starts at the bottom
+// of the following band from the steady state of the causal result there and
+// emits the first band. The error of this start decays with the impulse
+// response and stays below half an 8-bit step for HIPACC_RECURSIVE_BAND >=
+// 6*sigma. The last rows start from the last causal result like the CPU and
+// GPU implementations, so images of up to 2*HIPACC_RECURSIVE_BAND rows are
+// filtered exactly.
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, typename OUT>
+void processRecursiveColumns(
+    hls::stream<float> &in_s,
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    const float b, const float a1, const float a2, const float a3)
+{
+  assert(width <= MAX_WIDTH); assert(height <= MAX_HEIGHT);
+
+  const int BAND = HIPACC_RECURSIVE_BAND;
+  float rows[2*BAND][MAX_WIDTH];
+  float s1[MAX_WIDTH], s2[MAX_WIDTH], s3[MAX_WIDTH];
+  float t1[MAX_WIDTH], t2[MAX_WIDTH], t3[MAX_WIDTH];
+
+  // first row not emitted yet
+  int next = 0;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+      const float val = in_s.read();
+      if (y == 0) { s1[x] = val; s2[x] = val; s3[x] = val; }
+      const float y0 = b*val + a1*s1[x] + a2*s2[x] + a3*s3[x];
+      rows[y % (2*BAND)][x] = y0;
+      s3[x] = s2[x]; s2[x] = s1[x]; s1[x] = y0;
+    }
+
+    const bool last = y == height-1;
+    if (!last && y - next + 1 < 2*BAND)
+      continue;
+
+    // rows [next, end) are emitted, rows [end, y] only warm up the state
+    const int end = last ? height : next + BAND;
+    for (int r = y; r >= next; --r)
+      for (int x = 0; x < width; ++x) {
+        PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+        const float val = rows[r % (2*BAND)][x];
+        if (r == y) { t1[x] = val; t2[x] = val; t3[x] = val; }
+        const float y0 = b*val + a1*t1[x] + a2*t2[x] + a3*t3[x];
+        if (r < end)
+          rows[r % (2*BAND)][x] = y0;
+        t3[x] = t2[x]; t2[x] = t1[x]; t1[x] = y0;
+      }
+
+    for (int r = next; r < end; ++r)
+      for (int x = 0; x < width; ++x) {
+        PRAGMA_HLS(HLS pipeline ii=II_TARGET)
+        out_s.write(recursiveStore<OUT>(rows[r % (2*BAND)][x]));
+      }
+    next = end;
+  }
+}
+
+template<int II_TARGET, int MAX_WIDTH, int MAX_HEIGHT, typename IN, typename OUT>
+void processRecursive(
+    hls::stream<IN> &in_s,
+    hls::stream<OUT> &out_s,
+    const int &width,
+    const int &height,
+    const float b, const float a1, const float a2, const float a3)
+{
+  PRAGMA_HLS(HLS dataflow)
+  hls::stream<float> rows_s;
+
+  processRecursiveRows<II_TARGET, MAX_WIDTH, MAX_HEIGHT>(in_s, rows_s, width, height, b, a1, a2, a3);
+  processRecursiveColumns<II_TARGET, MAX_WIDTH, MAX_HEIGHT>(rows_s, out_s, width, height, b, a1, a2, a3);
+}
+
+
 //*********************************************************************************************************************
 // LEGACY (QUADRATIC KERNEL SIZE)
 //*********************************************************************************************************************
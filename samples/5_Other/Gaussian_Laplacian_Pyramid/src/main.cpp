@@ -60,21 +60,6 @@ class Gaussian : public Kernel<char> {
     }
 };
 
-class Subsample : public Kernel<char> {
-  private:
-    Accessor<char> &input;
-
-  public:
-    Subsample(IterationSpace<char> &iter, Accessor<char> &input)
-          : Kernel(iter), input(input) {
-        add_accessor(&input);
-    }
-
-    void kernel() {
-        output() = input();
-    }
-};
-
 class DifferenceOfGaussian : public Kernel<char> {
   private:
     Accessor<char> &input1;
@@ -182,38 +167,29 @@ int main(int argc, const char **argv) {
 
     // input and output image of width x height pixels
     Image<char> gaus(width, height, input);
-    Image<char> tmp(width, height);
     Image<char> lap(width, height);
     Mask<float> mask(coef);
 
     int depth = 5;
     Pyramid<char> pgaus(gaus, depth);
-    Pyramid<char> ptmp(tmp, depth);
     Pyramid<char> plap(lap, depth);
 
-    traverse(pgaus, ptmp, plap, [&] () {
+    traverse(pgaus, plap, [&] () {
         if (!pgaus.is_top_level()) {
-            // construct Gaussian pyramid
+            // construct Gaussian pyramid: blur and subsample in one pass
             BoundaryCondition<char> bound(pgaus(-1), mask, Boundary::CLAMP);
-            Accessor<char> acc1(bound);
-            IterationSpace<char> iter1(ptmp(-1));
+            Accessor<char> acc1(bound, Interpolate::RS);
+            IterationSpace<char> iter1(pgaus(0));
             Gaussian blur(iter1, acc1, mask);
             std::cout << "Level " << pgaus.level()-1 << ": Gaussian" << std::endl;
             blur.execute();
             timing += hipacc_last_kernel_timing();
 
-            Accessor<char> acc2(ptmp(-1), Interpolate::NN);
-            IterationSpace<char> iter2(pgaus(0));
-            Subsample sub(iter2, acc2);
-            std::cout << "Level " << pgaus.level()-1 << ": Subsample" << std::endl;
-            sub.execute();
-            timing += hipacc_last_kernel_timing();
-
             // construct Laplacian pyramid
-            Accessor<char> acc3(pgaus(-1));
-            Accessor<char> acc4(pgaus(0), Interpolate::LF);
-            IterationSpace<char> iter3(plap(-1));
-            DifferenceOfGaussian DoG(iter3, acc3, acc4);
+            Accessor<char> acc2(pgaus(-1));
+            Accessor<char> acc3(pgaus(0), Interpolate::LF);
+            IterationSpace<char> iter2(plap(-1));
+            DifferenceOfGaussian DoG(iter2, acc2, acc3);
             std::cout << "Level " << pgaus.level()-1 << ": DifferenceOfGaussian" << std::endl;
             DoG.execute();
             timing += hipacc_last_kernel_timing();